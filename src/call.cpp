@@ -272,49 +272,48 @@ Call::dumpSql(Sql *db, ostream &of)
 		Call *fun = i->second;
 		Tokid t = fun->get_site();
 		if (table_is_enabled(t_functions))
-			of << "INSERT INTO FUNCTIONS VALUES("
-			    << ptr_offset(fun) << ", '"
-			    << fun->name << "', "
-			    << db->boolval(fun->is_macro()) << ','
-			    << db->boolval(fun->is_defined()) << ','
-			    << db->boolval(fun->is_declared()) << ','
-			    << db->boolval(fun->is_file_scoped()) << ','
-			    << t.get_fileid().get_id() << ','
-			    << (unsigned)(t.get_streampos()) << ','
-			    << fun->get_num_caller()
-			    << ");\n";
-
-		if (fun->is_defined() && table_is_enabled(t_functiondefs)) {
-			of << "INSERT INTO FUNCTIONDEFS VALUES(" << ptr_offset(fun)
-			    << ',' << fun->get_begin().get_tokid().get_fileid().get_id() <<
-			    ',' << (unsigned)(fun->get_begin().get_tokid().get_streampos()) <<
-			    ',' << fun->get_end().get_tokid().get_fileid().get_id() <<
-			    ',' << (unsigned)(fun->get_end().get_tokid().get_streampos());
-			of << ");\n";
-		}
+			SqlRow(db, of, "FUNCTIONS") <<
+			    ptr_offset(fun) <<
+			    fun->name <<
+			    fun->is_macro() <<
+			    fun->is_defined() <<
+			    fun->is_declared() <<
+			    fun->is_file_scoped() <<
+			    t.get_fileid().get_id() <<
+			    (unsigned)(t.get_streampos()) <<
+			    fun->get_num_caller();
+
+		if (fun->is_defined() && table_is_enabled(t_functiondefs))
+			SqlRow(db, of, "FUNCTIONDEFS") << ptr_offset(fun) <<
+			    fun->get_begin().get_tokid().get_fileid().get_id() <<
+			    (unsigned)(fun->get_begin().get_tokid().get_streampos()) <<
+			    fun->get_end().get_tokid().get_fileid().get_id() <<
+			    (unsigned)(fun->get_end().get_tokid().get_streampos());
 		if (fun->is_defined() && table_is_enabled(t_functionmetrics)) {
-			of << "INSERT INTO FUNCTIONMETRICS VALUES("
-			    << ptr_offset(fun) << ',' << db->boolval(true);
-			for (int j = 0; j < FunMetrics::metric_max; j++) {
-				if (Metrics::is_internal<FunMetrics>(j))
-					continue;
-				if (Metrics::is_pre_cpp<FunMetrics>(j))
-					of << ',' << fun->get_pre_cpp_metrics().get_metric(j);
-				else
-					cout << ",NULL";
+			{
+				SqlRow row(db, of, "FUNCTIONMETRICS");
+				row << ptr_offset(fun) << true;
+				for (int j = 0; j < FunMetrics::metric_max; j++) {
+					if (Metrics::is_internal<FunMetrics>(j))
+						continue;
+					if (Metrics::is_pre_cpp<FunMetrics>(j))
+						row << fun->get_pre_cpp_metrics().get_metric(j);
+					else
+						row.null();
+				}
 			}
-			of << ");\n";
-			of << "INSERT INTO FUNCTIONMETRICS VALUES("
-			    << ptr_offset(fun) << ',' << db->boolval(false);
-			for (int j = 0; j < FunMetrics::metric_max; j++) {
-				if (Metrics::is_internal<FunMetrics>(j))
-					continue;
-				if (Metrics::is_post_cpp<FunMetrics>(j))
-					of << ',' << fun->get_post_cpp_metrics().get_metric(j);
-				else
-					cout << ",NULL";
+			{
+				SqlRow row(db, of, "FUNCTIONMETRICS");
+				row << ptr_offset(fun) << false;
+				for (int j = 0; j < FunMetrics::metric_max; j++) {
+					if (Metrics::is_internal<FunMetrics>(j))
+						continue;
+					if (Metrics::is_post_cpp<FunMetrics>(j))
+						row << fun->get_post_cpp_metrics().get_metric(j);
+					else
+						row.null();
+				}
 			}
-			of << ");\n";
 		}
 
 		int start = 0, ord = 0;
@@ -325,10 +324,8 @@ Call::dumpSql(Sql *db, ostream &of)
 			while (pos < len) {
 				Eclass *ec = t2.get_ec();
 				if (table_is_enabled(t_functionid))
-					of << "INSERT INTO FUNCTIONID VALUES("
-					    << ptr_offset(fun) << ','
-					    << ord << ','
-					    << ptr_offset(ec) << ");\n";
+					SqlRow(db, of, "FUNCTIONID") << ptr_offset(fun) <<
+					    ord << ptr_offset(ec);
 				pos += ec->get_len();
 				t2 += ec->get_len();
 				ord++;
@@ -342,9 +339,8 @@ Call::dumpSql(Sql *db, ostream &of)
 		for (const_fmap_iterator_type i = fbegin(); i != fend(); i++) {
 			Call *fun = i->second;
 			for (Call::const_fiterator_type dest = fun->call_begin(); dest != fun->call_end(); dest++)
-				of << "INSERT INTO FCALLS VALUES(" <<
-				    ptr_offset(fun) << ',' <<
-				    ptr_offset(*dest) << ");\n";
+				SqlRow(db, of, "FCALLS") << ptr_offset(fun) <<
+				    ptr_offset(*dest);
 		}
 }
 
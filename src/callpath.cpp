@@ -0,0 +1,162 @@
+/*
+ * (C) Copyright 2026 Diomidis Spinellis
+ *
+ * This file is part of CScout.
+ *
+ * CScout is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * CScout is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with CScout.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *
+ * For documentation read the corresponding .h file
+ *
+ */
+
+#include <climits>
+#include <set>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+#include "call.h"
+#include "callpath.h"
+
+bool
+CallPath::function_order::operator()(const Call *a, const Call *b) const
+{
+	if (a->get_tokid() < b->get_tokid())
+		return true;
+	if (b->get_tokid() < a->get_tokid())
+		return false;
+	return a->get_name() < b->get_name();
+}
+
+bool
+CallPath::call_order::operator()(const pair <Call *, Call *> &a, const pair <Call *, Call *> &b) const
+{
+	function_order less;
+
+	if (less(a.first, b.first))
+		return true;
+	if (less(b.first, a.first))
+		return false;
+	return less(a.second, b.second);
+}
+
+CallPath::CallPath(Call *from, Call *to, size_t b) :
+	budget(b), visits(0), result(cp_none)
+{
+	if (from == to) {
+		nodes.insert(from);
+		for (Call::const_fiterator_type i = from->call_begin(); i != from->call_end(); i++)
+			if (*i == from)
+				edges.insert(make_pair(from, from));
+		result = cp_found;
+		return;
+	}
+
+	Distance from_dist, to_dist;
+	Frontier from_frontier(1, from), to_frontier(1, to);
+	from_dist[from] = 0;
+	to_dist[to] = 0;
+	bool met = false;
+	while (!met && !from_frontier.empty() && !to_frontier.empty()) {
+		bool ok = from_frontier.size() <= to_frontier.size() ?
+		    expand(from_frontier, from_dist, to_dist,
+			&Call::call_begin, &Call::call_end, met) :
+		    expand(to_frontier, to_dist, from_dist,
+			&Call::caller_begin, &Call::caller_end, met);
+		if (!ok) {
+			result = cp_budget;
+			return;
+		}
+	}
+	if (!met)
+		return;
+
+	/*
+	 * Each direction has visited all functions up to the depth it
+	 * reached, and the two depths add up to at least the length of
+	 * the shortest paths.  Therefore, every shortest path passes through
+	 * a function visited by both searches, whose two distances add up
+	 * to that (minimum) length.  The paths are traced from these
+	 * meeting functions back to each end through the distances
+	 * recorded by the corresponding search.
+	 */
+	int length = INT_MAX;
+	for (Distance::const_iterator i = from_dist.begin(); i != from_dist.end(); i++) {
+		Distance::const_iterator j = to_dist.find(i->first);
+		if (j != to_dist.end() && i->second + j->second < length)
+			length = i->second + j->second;
+	}
+	Frontier meet;
+	for (Distance::const_iterator i = from_dist.begin(); i != from_dist.end(); i++) {
+		Distance::const_iterator j = to_dist.find(i->first);
+		if (j != to_dist.end() && i->second + j->second == length)
+			meet.push_back(i->first);
+	}
+	nodes.insert(meet.begin(), meet.end());
+	collect(meet, from_dist, &Call::caller_begin, &Call::caller_end, false);
+	collect(meet, to_dist, &Call::call_begin, &Call::call_end, true);
+	result = cp_found;
+}
+
+bool
+CallPath::expand(Frontier &frontier, Distance &dist, const Distance &other,
+    Call::const_fiterator_type (Call::*fbegin)() const,
+    Call::const_fiterator_type (Call::*fend)() const,
+    bool &met)
+{
+	Frontier next;
+
+	for (Frontier::const_iterator f = frontier.begin(); f != frontier.end(); f++) {
+		int d = dist[*f] + 1;
+		for (Call::const_fiterator_type i = ((*f)->*fbegin)(); i != ((*f)->*fend)(); i++) {
+			if (dist.find(*i) != dist.end())
+				continue;
+			if (budget && ++visits > budget)
+				return false;
+			dist[*i] = d;
+			next.push_back(*i);
+			if (other.find(*i) != other.end())
+				met = true;
+		}
+	}
+	frontier.swap(next);
+	return true;
+}
+
+void
+CallPath::collect(Frontier work, const Distance &dist,
+    Call::const_fiterator_type (Call::*fbegin)() const,
+    Call::const_fiterator_type (Call::*fend)() const,
+    bool reverse)
+{
+	set <Call *> seen(work.begin(), work.end());
+
+	while (!work.empty()) {
+		Call *f = work.back();
+		work.pop_back();
+		int d = dist.find(f)->second;
+		if (d == 0)
+			continue;
+		for (Call::const_fiterator_type i = (f->*fbegin)(); i != (f->*fend)(); i++) {
+			Distance::const_iterator n = dist.find(*i);
+			if (n == dist.end() || n->second != d - 1)
+				continue;
+			edges.insert(reverse ? make_pair(f, *i) : make_pair(*i, f));
+			nodes.insert(*i);
+			if (seen.insert(*i).second)
+				work.push_back(*i);
+		}
+	}
+}
@@ -0,0 +1,101 @@
+/*
+ * (C) Copyright 2026 Diomidis Spinellis
+ *
+ * This file is part of CScout.
+ *
+ * CScout is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * CScout is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with CScout.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *
+ * The subgraph of the shortest call paths between two functions.
+ * The paths are found through a bidirectional breadth-first search,
+ * which expands the smaller of the frontiers reached from the
+ * calling function along its calls, and from the called function
+ * along its callers, until the two meet.
+ * The search keeps its own visitation state; it does not use the
+ * visit and print flags of Call, and can thus run concurrently
+ * with other searches.
+ *
+ */
+
+#ifndef CALLPATH_
+#define CALLPATH_
+
+#include <cstddef>
+#include <set>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+using namespace std;
+
+#include "call.h"
+
+class CallPath {
+public:
+	enum e_result {
+		cp_found,		// Paths were found
+		cp_none,		// There is no path
+		cp_budget		// The visit budget was exhausted
+	};
+	// Order functions by their token and name, which are stable across runs
+	struct function_order {
+		bool operator()(const Call *a, const Call *b) const;
+	};
+	// Order calls by their calling and then their called function
+	struct call_order {
+		bool operator()(const pair <Call *, Call *> &a, const pair <Call *, Call *> &b) const;
+	};
+	typedef set <Call *, function_order> Nodes;
+	typedef set <pair <Call *, Call *>, call_order> Edges;
+private:
+	typedef unordered_map <Call *, int> Distance;	// Path lengths
+	typedef vector <Call *> Frontier;	// Functions to expand next
+
+	size_t budget;			// Maximum number of visits; 0 for none
+	size_t visits;			// Number of functions visited
+	e_result result;
+	Nodes nodes;			// Functions on the shortest paths
+	Edges edges;			// Calls on the shortest paths
+
+	/*
+	 * Expand the search from the functions in frontier by one level,
+	 * following the relationship obtained through fbegin and fend.
+	 * Set met to true if a function reached by the other direction's
+	 * search (other) is found.
+	 * Return false if the visit budget was exhausted.
+	 */
+	bool expand(Frontier &frontier, Distance &dist, const Distance &other,
+	    Call::const_fiterator_type (Call::*fbegin)() const,
+	    Call::const_fiterator_type (Call::*fend)() const,
+	    bool &met);
+	/*
+	 * Add to the subgraph the calls leading from the functions in work
+	 * to the search's origin, which is at distance 0 in dist.
+	 */
+	void collect(Frontier work, const Distance &dist,
+	    Call::const_fiterator_type (Call::*fbegin)() const,
+	    Call::const_fiterator_type (Call::*fend)() const,
+	    bool reverse);
+public:
+	/*
+	 * Find the shortest call paths from function from to function to,
+	 * visiting at most budget functions (no limit if it is 0).
+	 */
+	CallPath(Call *from, Call *to, size_t budget = 0);
+	e_result get_result() const { return result; }
+	const Nodes &get_nodes() const { return nodes; }
+	const Edges &get_edges() const { return edges; }
+};
+
+#endif /* CALLPATH_ */
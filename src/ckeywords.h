@@ -0,0 +1,66 @@
+/*
+ * (C) Copyright 2026 Diomidis Spinellis
+ *
+ * This file is part of CScout.
+ *
+ * CScout is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * CScout is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with CScout.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *
+ * The C keywords and their token values, used for building the
+ * table through which the lexical analyzer recognizes keywords.
+ *
+ */
+
+#ifndef CKEYWORDS_
+#define CKEYWORDS_
+
+#include <initializer_list>
+#include <utility>
+
+using namespace std;
+
+#include "parse.tab.h"
+
+static const initializer_list <pair <const char *, int> > c_keywords = {
+	{"auto", AUTO}, {"double", DOUBLE}, {"int", INT}, {"struct", STRUCT},
+	{"break", BREAK}, {"else", ELSE}, {"long", LONG}, {"switch", SWITCH},
+	{"case", CASE}, {"enum", ENUM}, {"register", REGISTER},
+	{"typedef", TYPEDEF}, {"char", CHAR}, {"extern", EXTERN},
+	{"return", RETURN}, {"union", UNION}, {"const", TCONST},
+	{"float", FLOAT}, {"short", SHORT}, {"unsigned", UNSIGNED},
+	{"continue", CONTINUE}, {"for", FOR}, {"signed", SIGNED},
+	{"void", TVOID}, {"default", DEFAULT}, {"goto", GOTO},
+	{"sizeof", SIZEOF}, {"volatile", VOLATILE}, {"do", DO}, {"if", IF},
+	{"static", STATIC}, {"while", WHILE},
+	/* C99 */
+	{"inline", INLINE}, {"restrict", RESTRICT}, {"_Bool", BOOL},
+	{"_Complex", COMPLEX}, {"_Imaginary", IMAGINARY},
+	/* C11 */
+	{"_Thread_local", THREAD_LOCAL}, {"_Generic", GENERIC},
+	/* Microsoft */
+	{"_asm", MSC_ASM}, {"__try", TRY}, {"__except", EXCEPT},
+	{"__finally", FINALLY}, {"__leave", LEAVE},
+	/* gcc; from c-parse.in */
+	{"__asm", GNUC_ASM}, {"__asm__", GNUC_ASM}, {"__attribute", ATTRIBUTE},
+	{"__attribute__", ATTRIBUTE}, {"__builtin_choose_expr", CHOOSE_EXPR},
+	{"__const", TCONST}, {"__const__", TCONST}, {"__inline", INLINE},
+	{"__inline__", INLINE}, {"__label", LABEL}, {"__label__", LABEL},
+	{"__restrict", RESTRICT}, {"__restrict__", RESTRICT},
+	{"__signed", SIGNED}, {"__signed__", SIGNED}, {"__typeof", TYPEOF},
+	{"__typeof__", TYPEOF}, {"__alignof", ALIGNOF},
+	{"__alignof__", ALIGNOF}, {"__volatile", VOLATILE},
+	{"__volatile__", VOLATILE},
+};
+
+#endif /* CKEYWORDS_ */
@@ -0,0 +1,365 @@
+/*
+ * (C) Copyright 2026 Diomidis Spinellis
+ *
+ * This file is part of CScout.
+ *
+ * CScout is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * CScout is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with CScout.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *
+ * For documentation read the corresponding .h file
+ *
+ */
+
+#include <algorithm>
+#include <iostream>
+#include <map>
+#include <set>
+#include <string>
+#include <tuple>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
+
+#include "cpp.h"
+#include "debug.h"
+#include "error.h"
+#include "attr.h"
+#include "fileid.h"
+#include "tokid.h"
+#include "token.h"
+#include "fchar.h"
+#include "eclass.h"
+#include "filedetails.h"
+#include "idquery.h"
+#include "parallel.h"
+#include "clashcheck.h"
+
+bool ClashCheck::enabled;
+vector <ClashCheck::Scope> ClashCheck::scopes;
+vector <ClashCheck::Unit> ClashCheck::units;
+int ClashCheck::current_unit = -1;
+vector <vector <ClashCheck::Decl> > ClashCheck::macro_scopes;
+unordered_set <string> ClashCheck::seen;
+unordered_set <string> ClashCheck::names;
+
+// The ECs of an identifier's parts; one for identifiers that are not pasted
+typedef vector <Eclass *> Ident;
+
+// The identifiers declared with each name in each scope and namespace
+typedef map <tuple <int, int, string>, vector <Ident> > NameIndex;
+
+// State of the current check, read concurrently by check_unit
+static unordered_map <Eclass *, string> renamed;	// New names of renamed ECs
+static set <string> new_names;		// Names given to renamed identifiers
+static set <string> check_names;	// New and old names of renamed identifiers
+static NameIndex macro_names;		// Macros by their new name
+
+ClashCheck::Decl::Decl(int s, e_table t, const string *n, const Token &tok) :
+	scope(s), table(t), name(n), tokid(tok.get_parts_begin()->get_tokid())
+{
+	dequeTpart::const_iterator i = tok.get_parts_begin();
+	for (i++; i != tok.get_parts_end(); i++)
+		pasted.push_back(i->get_tokid());
+}
+
+bool
+ClashCheck::get_ecs(const Decl &d, vector <Eclass *> &ecs)
+{
+	ecs.clear();
+	ecs.push_back(d.tokid.get_ec());
+	for (vector <Tokid>::const_iterator i = d.pasted.begin(); i != d.pasted.end(); i++)
+		ecs.push_back(i->get_ec());
+	return find(ecs.begin(), ecs.end(), (Eclass *)NULL) == ecs.end();
+}
+
+int
+ClashCheck::block_scope(int parent, bool new_unit)
+{
+	if (!enabled)
+		return -1;
+	if (macro_scopes.empty())
+		macro_scopes.push_back(vector <Decl>());
+	int unit;
+	if (new_unit) {
+		unit = current_unit = units.size();
+		units.push_back(Unit());
+		seen.clear();
+	} else if (parent >= 0)
+		unit = scopes[parent].unit;
+	else
+		unit = context_unit();
+	scopes.push_back(Scope(parent, unit, macro_scopes.size() - 1));
+	return scopes.size() - 1;
+}
+
+int
+ClashCheck::scope()
+{
+	if (!enabled)
+		return -1;
+	if (units.empty())
+		return block_scope(-1, true);
+	return block_scope(-1, false);
+}
+
+void
+ClashCheck::macro_scope()
+{
+	if (enabled)
+		macro_scopes.push_back(vector <Decl>());
+}
+
+void
+ClashCheck::declare(int scope, e_table table, const Token &tok)
+{
+	if (scope < 0 || tok.get_parts_begin() == tok.get_parts_end())
+		return;
+	units[scopes[scope].unit].decls.push_back(Decl(scope, table, intern(tok.get_name()), tok));
+}
+
+void
+ClashCheck::declare_macro(const Token &tok)
+{
+	if (!enabled || tok.get_parts_begin() == tok.get_parts_end())
+		return;
+	if (macro_scopes.empty())
+		macro_scopes.push_back(vector <Decl>());
+	macro_scopes.back().push_back(Decl(macro_scopes.size() - 1, t_macro, intern(tok.get_name()), tok));
+}
+
+void
+ClashCheck::use(int scope, e_table table, const string &name)
+{
+	if (scope < 0)
+		return;
+	// Lookups of a name from the same scope resolve the same way
+	string key(name);
+	key += '\0';
+	key += to_string(scope);
+	key += (char)('0' + table);
+	if (!seen.insert(key).second)
+		return;
+	units[scopes[scope].unit].uses.push_back(Use(scope, table, intern(name), Fchar::get_fileid(), Fchar::get_line_num()));
+}
+
+/*
+ * Return the name of the identifier id, declared as name, after the
+ * renames.  Pasted identifiers are renamed part by part.
+ */
+static string
+final_name(const Ident &id, const string &name)
+{
+	if (id.size() == 1) {
+		unordered_map <Eclass *, string>::const_iterator i = renamed.find(id[0]);
+		return i == renamed.end() ? name : i->second;
+	}
+	string result;
+	for (Ident::const_iterator i = id.begin(); i != id.end(); i++) {
+		unordered_map <Eclass *, string>::const_iterator r = renamed.find(*i);
+		if (r != renamed.end()) {
+			result += r->second;
+			continue;
+		}
+		IdProp::const_iterator idi = Identifier::ids.find(*i);
+		if (idi == Identifier::ids.end())
+			return name;
+		result += idi->second.get_id();
+	}
+	return result;
+}
+
+// Return true if a part of a or b is renamed
+static bool
+is_renamed(const Ident *a, const Ident *b)
+{
+	if (a)
+		for (Ident::const_iterator i = a->begin(); i != a->end(); i++)
+			if (renamed.count(*i))
+				return true;
+	return b && is_renamed(b, NULL);
+}
+
+// Add id to the identifiers of the specified name index entry
+static void
+add_name(NameIndex &ni, int scope, int table, const string &name, const Ident &id)
+{
+	vector <Ident> &v(ni[make_tuple(scope, table, name)]);
+	if (find(v.begin(), v.end(), id) == v.end())
+		v.push_back(id);
+}
+
+// Return the identifiers declared in the specified index entry or NULL
+static const vector <Ident> *
+find_name(const NameIndex &ni, int scope, int table, const string &name)
+{
+	NameIndex::const_iterator i = ni.find(make_tuple(scope, table, name));
+	return i == ni.end() ? NULL : &i->second;
+}
+
+// Return a description of a clash on name at the specified location
+static string
+clash_message(Fileid fid, int line, const string &name)
+{
+	return fid.get_path() + "(" + to_string(line) + "): refactored identifier name clash: " + name;
+}
+
+void
+ClashCheck::check_unit(int u, vector <string> &msg)
+{
+	const Unit &unit(units[u]);
+	NameIndex before, after;
+	Ident id;
+
+	// Index the declarations of the relevant names
+	for (vector <Decl>::const_iterator i = unit.decls.begin(); i != unit.decls.end(); i++) {
+		if (!check_names.count(*i->name) || !get_ecs(*i, id))
+			continue;
+		add_name(before, i->scope, i->table, *i->name, id);
+		add_name(after, i->scope, i->table, final_name(id, *i->name), id);
+	}
+
+	// Report the identifiers of v other than id clashing with it
+	auto report = [&](const vector <Ident> *v, const Ident *id, Fileid fid, int line, const string &name) {
+		if (v)
+			for (vector <Ident>::const_iterator i = v->begin(); i != v->end(); i++)
+				if ((!id || *i != *id) && is_renamed(&*i, id)) {
+					msg.push_back(clash_message(fid, line, name));
+					return;
+				}
+	};
+
+	// Declarations must not clash with others in their scope
+	for (vector <Decl>::const_iterator i = unit.decls.begin(); i != unit.decls.end(); i++) {
+		if (!check_names.count(*i->name) || !get_ecs(*i, id))
+			continue;
+		string name(final_name(id, *i->name));
+		Fileid fid(i->tokid.get_fileid());
+		int line = Filedetails::get_line_number(fid, i->tokid.get_streampos());
+		report(find_name(after, i->scope, i->table, name), &id, fid, line, name);
+		report(find_name(macro_names, scopes[i->scope].macros, t_macro, name), &id, fid, line, name);
+	}
+
+	// Lookups must resolve to the same identifier as before
+	for (vector <Use>::const_iterator i = unit.uses.begin(); i != unit.uses.end(); i++) {
+		if (!check_names.count(*i->name))
+			continue;
+		const vector <Ident> *v = NULL;
+		for (int s = i->scope; s >= 0 && !v; s = scopes[s].parent)
+			v = find_name(before, s, i->table, *i->name);
+		const Ident *found = v ? &v->front() : NULL;
+		string name(found ? final_name(*found, *i->name) : *i->name);
+		if (!new_names.count(name) && !is_renamed(found, NULL))
+			continue;
+		v = NULL;
+		for (int s = i->scope; s >= 0 && !v; s = scopes[s].parent)
+			v = find_name(after, s, i->table, name);
+		report(v, found, i->fid, i->line, name);
+		report(find_name(macro_names, scopes[i->scope].macros, t_macro, name), found, i->fid, i->line, name);
+	}
+}
+
+bool
+ClashCheck::check()
+{
+	renamed.clear();
+	new_names.clear();
+	check_names.clear();
+	macro_names.clear();
+	for (IdProp::iterator i = Identifier::ids.begin(); i != Identifier::ids.end(); i++)
+		if (i->second.get_replaced() && i->second.get_active()) {
+			renamed[i->first] = i->second.get_newid();
+			new_names.insert(i->second.get_newid());
+			check_names.insert(i->second.get_newid());
+			check_names.insert(i->second.get_id());
+		}
+	if (renamed.empty())
+		return false;
+
+	// Add the old and new names of pasted identifiers with renamed parts
+	Ident id;
+	for (vector <Unit>::const_iterator u = units.begin(); u != units.end(); u++)
+		for (vector <Decl>::const_iterator i = u->decls.begin(); i != u->decls.end(); i++)
+			if (!i->pasted.empty() && get_ecs(*i, id) && is_renamed(&id, NULL)) {
+				string name(final_name(id, *i->name));
+				new_names.insert(name);
+				check_names.insert(name);
+				check_names.insert(*i->name);
+			}
+
+	vector <string> msg;
+
+	// Index the macros and find the macro scopes containing renamed ones
+	vector <bool> macros_affected(macro_scopes.size(), false);
+	for (vector <vector <Decl> >::size_type m = 0; m < macro_scopes.size(); m++)
+		for (vector <Decl>::const_iterator i = macro_scopes[m].begin(); i != macro_scopes[m].end(); i++) {
+			if (!check_names.count(*i->name) || !get_ecs(*i, id))
+				continue;
+			string name(final_name(id, *i->name));
+			const vector <Ident> *v = find_name(macro_names, m, t_macro, name);
+			if (v)
+				for (vector <Ident>::const_iterator j = v->begin(); j != v->end(); j++)
+					if (*j != id && is_renamed(&*j, &id)) {
+						Fileid fid(i->tokid.get_fileid());
+						msg.push_back(clash_message(fid,
+						    Filedetails::get_line_number(fid, i->tokid.get_streampos()), name));
+						break;
+					}
+			add_name(macro_names, m, t_macro, name, id);
+			if (is_renamed(&id, NULL))
+				macros_affected[m] = true;
+		}
+
+	// Find the units containing renamed identifiers
+	vector <char> affected(units.size(), false);
+	Parallel::for_each_index(units.size(), [&](size_t u) {
+		const vector <Decl> &decls(units[u].decls);
+		Ident id;
+		for (vector <Decl>::const_iterator i = decls.begin(); i != decls.end(); i++)
+			if (check_names.count(*i->name) && get_ecs(*i, id) && is_renamed(&id, NULL)) {
+				affected[u] = true;
+				break;
+			}
+	});
+	for (vector <Scope>::const_iterator i = scopes.begin(); i != scopes.end(); i++)
+		if (macros_affected[i->macros])
+			affected[i->unit] = true;
+	vector <int> check_units;
+	for (vector <char>::size_type u = 0; u < affected.size(); u++)
+		if (affected[u])
+			check_units.push_back(u);
+	if (DP())
+		cout << "Checking " << check_units.size() << " of " << units.size() << " units for clashes" << endl;
+
+	// Check them
+	vector <vector <string> > unit_msg(check_units.size());
+	Parallel::for_each_index(check_units.size(), [&](size_t i) {
+		check_unit(check_units[i], unit_msg[i]);
+	});
+	for (vector <vector <string> >::const_iterator i = unit_msg.begin(); i != unit_msg.end(); i++)
+		msg.insert(msg.end(), i->begin(), i->end());
+
+	// Report each clash once
+	set <string> reported;
+	for (vector <string>::const_iterator i = msg.begin(); i != msg.end(); i++)
+		if (reported.insert(*i).second)
+			/*
+			 * @error
+			 * A rename refactoring would give an identifier
+			 * the same name as another identifier that is
+			 * visible in the same scope.
+			 * The refactored files are not saved.
+			 */
+			Error::error(E_ERR, *i, false);
+	return !msg.empty();
+}
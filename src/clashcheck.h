@@ -0,0 +1,147 @@
+/*
+ * (C) Copyright 2026 Diomidis Spinellis
+ *
+ * This file is part of CScout.
+ *
+ * CScout is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * CScout is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with CScout.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *
+ * Checking of rename refactorings for identifier name clashes.
+ * While the workspace is processed, the symbol table records its
+ * scopes, the identifiers declared in each scope, and the names looked
+ * up from each scope.  When renamed identifiers are saved, the lookups
+ * of each compilation unit containing a renamed identifier are resolved
+ * again with the new names.  A lookup that resolves to a different
+ * identifier, or a declaration of a name already declared in the same
+ * scope by a different identifier, signifies a clash.
+ * Macros are considered to be visible from all the scopes of the
+ * compilation unit in which they are defined.
+ * Identifiers pasted together from several parts are identified by
+ * the ECs of all their parts, and get their new name part by part.
+ *
+ * The order of declarations within a scope is not recorded, so a lookup
+ * preceding a declaration is taken to see it.  This can report clashes
+ * that a compiler would not.  Lookups are however recorded only by name,
+ * so a lookup of a pasted identifier with renamed parts is checked
+ * under its original name, and its clashes can be missed.
+ *
+ */
+
+#ifndef CLASHCHECK_
+#define CLASHCHECK_
+
+#include <string>
+#include <unordered_set>
+#include <vector>
+
+using namespace std;
+
+#include "fileid.h"
+#include "tokid.h"
+
+class Token;
+
+class ClashCheck {
+public:
+	// The namespaces in which names are declared and looked up
+	enum e_table {
+		t_obj,		// Ordinary identifiers
+		t_tag,		// Structure, union, enumeration tags
+		t_label,	// Labels
+		t_member,	// Structure and union members
+		t_macro,	// Macros
+	};
+private:
+	struct Scope {
+		int parent;		// Enclosing scope or -1
+		int unit;		// Compilation unit
+		int macros;		// Macro scope visible from it
+		Scope(int p, int u, int m) : parent(p), unit(u), macros(m) {}
+	};
+	struct Decl {
+		int scope;
+		e_table table;
+		const string *name;	// Interned in names
+		Tokid tokid;		// For obtaining the identifier's EC
+		vector <Tokid> pasted;	// The other parts of pasted identifiers
+		Decl(int s, e_table t, const string *n, const Token &tok);
+	};
+	struct Use {
+		int scope;
+		e_table table;
+		const string *name;	// Interned in names
+		Fileid fid;		// Location of its first lookup
+		int line;
+		Use(int s, e_table t, const string *n, Fileid f, int l) :
+			scope(s), table(t), name(n), fid(f), line(l) {}
+	};
+	// The declarations and lookups of a compilation unit
+	struct Unit {
+		vector <Decl> decls;
+		vector <Use> uses;
+	};
+
+	static bool enabled;		// True if names are recorded
+	static vector <Scope> scopes;
+	static vector <Unit> units;	// The first is the linkage unit
+	static int current_unit;
+	static vector <vector <Decl> > macro_scopes;	// Macros of each scope
+	static unordered_set <string> seen;	// Uses recorded in this unit
+	static unordered_set <string> names;	// Declared and looked up names
+
+	// Return the interned copy of name
+	static const string *intern(const string &name) {
+		return &*names.insert(name).first;
+	}
+	/*
+	 * Set ecs to the ECs of the parts of the identifier d declares.
+	 * Return false if some part has no EC.
+	 */
+	static bool get_ecs(const Decl &d, vector <Eclass *> &ecs);
+
+	// Return the unit in which a scope without a parent is created
+	static int context_unit() { return current_unit < 0 ? 0 : current_unit; }
+	// Check the unit u, adding clash descriptions to msg
+	static void check_unit(int u, vector <string> &msg);
+public:
+	// Record the names; only done if refactor_check_clashes is set
+	static void enable() { enabled = true; }
+	static bool is_enabled() { return enabled; }
+
+	/*
+	 * Return a new block scope nested in parent (-1 for none),
+	 * which starts a new compilation unit if new_unit is true,
+	 * or -1 if names are not recorded.
+	 */
+	static int block_scope(int parent, bool new_unit);
+	// Return a new scope for labels or structure members
+	static int scope();
+	// Called when the defined macros are cleared
+	static void macro_scope();
+
+	// Record the declaration of tok in the specified scope
+	static void declare(int scope, e_table table, const Token &tok);
+	// Record the definition of the macro named by tok
+	static void declare_macro(const Token &tok);
+	// Record the lookup of name from the specified scope
+	static void use(int scope, e_table table, const string &name);
+
+	/*
+	 * Check the active identifier renames for clashes, reporting
+	 * them as errors.  Return true if clashes were found.
+	 */
+	static bool check();
+};
+
+#endif /* CLASHCHECK_ */
@@ -0,0 +1,181 @@
+/*
+ * (C) Copyright 2026 Diomidis Spinellis
+ *
+ * This file is part of CScout.
+ *
+ * CScout is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * CScout is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with CScout.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *
+ * For documentation read the corresponding .h file
+ *
+ */
+
+#include <cstdint>
+#include <cstring>
+#include <string>
+
+#ifdef HAVE_XXHASH
+#include <xxhash.h>
+#endif
+
+#include "fileid.h"
+#include "md5.h"
+#include "contenthash.h"
+
+// MD5 message digest
+static FileHash
+md5(const char *data, size_t len)
+{
+	unsigned char *h = MD5Buffer((const unsigned char *)data, len);
+	return FileHash(h, h + 16);
+}
+
+static inline uint64_t
+rotl64(uint64_t x, int r)
+{
+	return (x << r) | (x >> (64 - r));
+}
+
+static inline uint64_t
+fmix64(uint64_t k)
+{
+	k ^= k >> 33;
+	k *= 0xff51afd7ed558ccdULL;
+	k ^= k >> 33;
+	k *= 0xc4ceb9fe1a85ec53ULL;
+	k ^= k >> 33;
+	return k;
+}
+
+// Append the eight little-endian bytes of v to h
+static void
+append64(FileHash &h, uint64_t v)
+{
+	for (int i = 0; i < 8; i++, v >>= 8)
+		h.push_back((unsigned char)v);
+}
+
+// MurmurHash3 x64 128-bit variant, by Austin Appleby, with a zero seed
+static FileHash
+murmur3(const char *data, size_t len)
+{
+	const uint64_t c1 = 0x87c37b91114253d5ULL;
+	const uint64_t c2 = 0x4cf5ad432745937fULL;
+	const unsigned char *p = (const unsigned char *)data;
+	size_t nblocks = len / 16;
+	uint64_t h1 = 0, h2 = 0;
+	uint64_t k1, k2;
+
+	for (size_t i = 0; i < nblocks; i++, p += 16) {
+		memcpy(&k1, p, 8);
+		memcpy(&k2, p + 8, 8);
+
+		k1 *= c1; k1 = rotl64(k1, 31); k1 *= c2; h1 ^= k1;
+		h1 = rotl64(h1, 27); h1 += h2; h1 = h1 * 5 + 0x52dce729;
+		k2 *= c2; k2 = rotl64(k2, 33); k2 *= c1; h2 ^= k2;
+		h2 = rotl64(h2, 31); h2 += h1; h2 = h2 * 5 + 0x38495ab5;
+	}
+
+	// The remaining bytes
+	k1 = k2 = 0;
+	switch (len & 15) {
+	case 15: k2 ^= (uint64_t)p[14] << 48;	/* FALLTHROUGH */
+	case 14: k2 ^= (uint64_t)p[13] << 40;	/* FALLTHROUGH */
+	case 13: k2 ^= (uint64_t)p[12] << 32;	/* FALLTHROUGH */
+	case 12: k2 ^= (uint64_t)p[11] << 24;	/* FALLTHROUGH */
+	case 11: k2 ^= (uint64_t)p[10] << 16;	/* FALLTHROUGH */
+	case 10: k2 ^= (uint64_t)p[9] << 8;	/* FALLTHROUGH */
+	case 9: k2 ^= (uint64_t)p[8];
+		k2 *= c2; k2 = rotl64(k2, 33); k2 *= c1; h2 ^= k2;
+		/* FALLTHROUGH */
+	case 8: k1 ^= (uint64_t)p[7] << 56;	/* FALLTHROUGH */
+	case 7: k1 ^= (uint64_t)p[6] << 48;	/* FALLTHROUGH */
+	case 6: k1 ^= (uint64_t)p[5] << 40;	/* FALLTHROUGH */
+	case 5: k1 ^= (uint64_t)p[4] << 32;	/* FALLTHROUGH */
+	case 4: k1 ^= (uint64_t)p[3] << 24;	/* FALLTHROUGH */
+	case 3: k1 ^= (uint64_t)p[2] << 16;	/* FALLTHROUGH */
+	case 2: k1 ^= (uint64_t)p[1] << 8;	/* FALLTHROUGH */
+	case 1: k1 ^= (uint64_t)p[0];
+		k1 *= c1; k1 = rotl64(k1, 31); k1 *= c2; h1 ^= k1;
+	}
+
+	h1 ^= len;
+	h2 ^= len;
+	h1 += h2;
+	h2 += h1;
+	h1 = fmix64(h1);
+	h2 = fmix64(h2);
+	h1 += h2;
+	h2 += h1;
+
+	FileHash r;
+	r.reserve(16);
+	append64(r, h1);
+	append64(r, h2);
+	return r;
+}
+
+#ifdef HAVE_XXHASH
+// XXH3 128-bit hash, which uses the processor's vector instructions
+static FileHash
+xxh128(const char *data, size_t len)
+{
+	XXH128_hash_t h = XXH3_128bits(data, len);
+	FileHash r;
+	r.reserve(16);
+	append64(r, h.low64);
+	append64(r, h.high64);
+	return r;
+}
+#endif
+
+// The available algorithms; the first one is the default
+static const struct {
+	const char *name;
+	ContentHash::Function function;
+} hashes[] = {
+#ifdef HAVE_XXHASH
+	{ "xxh128", xxh128 },
+#endif
+	{ "murmur3", murmur3 },
+	{ "md5", md5 },
+};
+
+string ContentHash::name(hashes[0].name);
+ContentHash::Function ContentHash::function = hashes[0].function;
+
+bool
+ContentHash::set_algorithm(const string &n)
+{
+	for (size_t i = 0; i < sizeof(hashes) / sizeof(hashes[0]); i++)
+		if (n == hashes[i].name) {
+			name = n;
+			function = hashes[i].function;
+			return true;
+		}
+	return false;
+}
+
+string
+ContentHash::algorithms()
+{
+	string r;
+
+	for (size_t i = 0; i < sizeof(hashes) / sizeof(hashes[0]); i++) {
+		if (i)
+			r += ' ';
+		r += hashes[i].name;
+	}
+	return r;
+}
@@ -0,0 +1,66 @@
+/*
+ * (C) Copyright 2026 Diomidis Spinellis
+ *
+ * This file is part of CScout.
+ *
+ * CScout is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * CScout is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with CScout.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *
+ * Hashing of file contents, used for finding identical files.
+ * The hash algorithm is selected with the -H command-line option.
+ * The following are available.
+ * md5		The MD5 message digest
+ * murmur3	The 128-bit x64 variant of MurmurHash3 (the default)
+ * xxh128	The XXH3 128-bit hash (the default, when compiled with
+ *		the xxHash library by defining HAVE_XXHASH)
+ * The non-cryptographic hashes are several times faster than MD5;
+ * collisions are not a concern, because the contents of the files
+ * compared are not adversarial.
+ *
+ */
+
+#ifndef CONTENTHASH_
+#define CONTENTHASH_
+
+#include <cstddef>
+#include <string>
+
+using namespace std;
+
+#include "fileid.h"
+
+class ContentHash {
+public:
+	// Return the hash of the len bytes at data with the selected algorithm
+	typedef FileHash (*Function)(const char *data, size_t len);
+private:
+	static string name;		// Name of the selected algorithm
+	static Function function;	// Its function
+public:
+	/*
+	 * Select the named hash algorithm.
+	 * Return false if no such algorithm is available.
+	 */
+	static bool set_algorithm(const string &n);
+	static const string &get_algorithm() { return name; }
+	// Return a space-separated list of the available algorithms
+	static string algorithms();
+
+	// Return the hash of the len bytes at data
+	static FileHash compute(const char *data, size_t len) {
+		return function(data, len);
+	}
+};
+
+#endif /* CONTENTHASH_ */
@@ -116,7 +116,7 @@ CREATE STRUCT VIEW Tokid (
 
 CREATE VIRTUAL TABLE cscout.Tokids
 USING STRUCT VIEW Tokid
-WITH REGISTERED C TYPE set<Tokid>;
+WITH REGISTERED C TYPE TokidSet;
 
 CREATE VIRTUAL TABLE cscout.Tokid
 USING STRUCT VIEW Tokid
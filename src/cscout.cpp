@@ -44,6 +44,14 @@
 #include <regex.h> // regex
 
 #include <getopt.h>
+#ifndef WIN32
+#include <sys/wait.h>		// wait
+#include <unistd.h>		// fork
+#endif
+#ifdef __linux__
+#include <sys/prctl.h>		// prctl
+#include <csignal>		// SIGTERM
+#endif
 
 #include "swill.h"
 
@@ -74,6 +82,13 @@
 #include "query.h"
 #include "mquery.h"
 #include "idquery.h"
+#include "idindex.h"
+#include "clashcheck.h"
+#include "pagecache.h"
+#include "json.h"
+#include "callpath.h"
+#include "reach.h"
+#include "srcspans.h"
 #include "funquery.h"
 #include "filequery.h"
 #include "logo.h"
@@ -82,6 +97,7 @@
 #include "dirbrowse.h"
 #include "fileutils.h"
 #include "globobj.h"
+#include "fileview.h"
 #include "fifstream.h"
 #include "ctag.h"
 #include "timer.h"
@@ -96,6 +112,9 @@ using namespace picoQL;
 #include "sql.h"
 #include "workdb.h"
 #include "obfuscate.h"
+#include "parallel.h"
+#include "contenthash.h"
+#include "profiler.h"
 
 #define ids Identifier::ids
 
@@ -176,8 +195,12 @@ public:
 
 RefFunCall::store_type RefFunCall::store;
 
-// Matrix used to store graph edges
-typedef vector<vector<bool> > EdgeMatrix;
+/*
+ * Graph edges: the files each file is connected to.
+ * The connected files are kept in name order, which is the
+ * order in which graphs output the files.
+ */
+typedef map <Fileid, IFSet> EdgeMap;
 
 // Boundaries of a function argument
 struct ArgBound {
@@ -274,34 +297,87 @@ html_string(FILE *of, const Call *f)
 	}
 }
 
-// Add identifiers of the file fi into ids
-// Collect metrics for the file and its functions
-// Populate the file's accociated files set
-// Return true if the file contains unused identifiers
-static bool
-file_analyze(Fileid fi)
+/*
+ * The results of post-processing a file that affect state shared
+ * with other files or with the file's later processing steps.
+ * They are gathered by file_scan(), possibly concurrently with the
+ * scanning of other files, and are applied in file order by
+ * file_commit().
+ */
+struct FileAnalysis {
+	FileMetrics metrics;			// The file's pre-cpp metrics
+	vector <Call *> funs;			// The file's functions
+	vector <FunMetrics> fun_metrics;	// and their pre-cpp metrics
+	vector <streampos> line_ends;		// Offsets of line ends
+	// The file's identifier ECs, with their name and number of occurences
+	map <Eclass *, pair <string, int> > identifiers;
+	vector <pair <Call *, int> > nneparam;	// Macro em_nneparam values
+	vector <Eclass *> removed;		// ECs the file removes
+	vector <Eclass *> skipped;		// ECs assumed removed earlier
+	bool has_unused;			// True if unused identifiers exist
+};
+
+// Shared context for scanning files concurrently (see file_scan)
+struct ScanContext {
+	vector <int> rank;		// Processing order of each Fileid
+	set <Eclass *> removed;		// ECs removed by committed files
+	bool speculative;		// True while scanning concurrently
+};
+
+/*
+ * Return the file that is processed first among those containing ec.
+ * This is the one that will remove it, if it must be removed.
+ */
+static Fileid
+first_file(const ScanContext &ctx, Eclass *ec)
+{
+	const setTokid &m(ec->get_members());
+	Fileid r = m.begin()->get_fileid();
+	for (setTokid::const_iterator i = m.begin(); i != m.end(); i++)
+		if (ctx.rank[i->get_fileid().get_id()] < ctx.rank[r.get_id()])
+			r = i->get_fileid();
+	return r;
+}
+
+/*
+ * Scan the file fi to collect its identifiers and its file and
+ * function metrics into r.
+ * The function does not modify the tokid map, the ECs, or other global
+ * state, so it can run concurrently for different files.
+ * ECs removed by the processing of files that come earlier in
+ * the file order are taken to be the ones in ctx.removed, or,
+ * for speculative scans, the ones that also appear in an earlier file.
+ * The latter assumption is verified by file_commit.
+ */
+static void
+file_scan(Fileid fi, const ScanContext &ctx, FileAnalysis &r)
 {
 	using namespace std::rel_ops;
 
 	fifstream in;
-	bool has_unused = false;
 	const string &fname = fi.get_path();
 	int line_number = 0;
+	set <Eclass *> removed_here;		// ECs removed by this scan
 
-
+	r.metrics = Filedetails::get_pre_cpp_metrics(fi);
 	FCallSet &fc = Filedetails::get_functions(fi);	// File's functions
-	FCallSet::iterator fci = fc.begin();	// Iterator through them
-	Call *cfun = NULL;			// Current function
-	stack <Call *> fun_nesting;
-
-	cerr << "Post-processing " << fname << endl;
-	in.open(fname.c_str(), ios::binary);
+	r.funs.assign(fc.begin(), fc.end());
+	r.fun_metrics.clear();
+	for (vector <Call *>::const_iterator i = r.funs.begin(); i != r.funs.end(); i++)
+		r.fun_metrics.push_back((*i)->get_pre_cpp_metrics());
+	unsigned fci = 0;			// Index through them
+	FunMetrics *cfun = NULL;		// Current function
+	Call *cfun_call = NULL;			// and its call
+	stack <unsigned> fun_nesting;
+	r.has_unused = false;
+
+	in.open(fi);
 	if (in.fail()) {
 		perror(fname.c_str());
 		exit(1);
 	}
 
-	MacroArgProcessor ma_proc;
+	MacroArgProcessor ma_proc(r.nneparam);
 
 	// Go through the file character by character
 	for (;;) {
@@ -313,28 +389,30 @@ file_analyze(Fileid fi)
 			break;
 
 		// Update current_function
-		if (cfun && ti > cfun->get_end().get_tokid()) {
-			cfun->get_pre_cpp_metrics().summarize_identifiers();
-			if (cfun->is_cfun())
-				cfun->get_pre_cpp_metrics().adjust_cfun_metrics();
+		if (cfun && ti > cfun_call->get_end().get_tokid()) {
+			cfun->summarize_identifiers();
+			if (cfun_call->is_cfun())
+				cfun->adjust_cfun_metrics();
 			if (fun_nesting.empty())
 				cfun = NULL;
 			else {
-				cfun = fun_nesting.top();
+				cfun = &r.fun_metrics[fun_nesting.top()];
+				cfun_call = r.funs[fun_nesting.top()];
 				fun_nesting.pop();
 			}
 		}
 		// See if entering a new function
-		if (fci != fc.end() && ti >= (*fci)->get_begin().get_tokid()) {
+		if (fci < r.funs.size() && ti >= r.funs[fci]->get_begin().get_tokid()) {
 			if (cfun)
-				fun_nesting.push(cfun);
-			cfun = *fci;
+				fun_nesting.push(cfun - &r.fun_metrics[0]);
+			cfun = &r.fun_metrics[fci];
+			cfun_call = r.funs[fci];
 			fci++;
 		}
 
 		char c = (char)val;
-		mapTokidEclass::iterator ei;
-		enum e_cfile_state cstate = Filedetails::get_pre_cpp_metrics(fi).get_state();
+		Eclass *ec;
+		enum e_cfile_state cstate = r.metrics.get_state();
 
 		ma_proc.process_char(cstate, c);
 
@@ -343,83 +421,186 @@ file_analyze(Fileid fi)
 		    cstate != s_string &&
 		    cstate != s_cpp_comment &&
 		    (isalnum(c) || c == '_') &&
-		    (ei = ti.find_ec()) != ti.end_ec()) {
-			Eclass *ec = (*ei).second;
-			// Remove identifiers we are not supposed to monitor
+		    (ec = ti.check_ec()) != NULL &&
+		    removed_here.find(ec) == removed_here.end() &&
+		    ctx.removed.find(ec) == ctx.removed.end()) {
+			// Identifiers we are not supposed to monitor
+			bool rejected = false;
 			if (monitor.is_valid()) {
 				IdPropElem ec_id(ec, Identifier());
-				if (!monitor.eval(ec_id)) {
-					ec->remove_from_tokid_map();
-					delete ec;
-					continue;
-				}
+				rejected = !monitor.eval(ec_id);
 			}
-
-			string s(1, c);
-			int len = ec->get_len();
-			for (int j = 1; j < len; j++)
-				s += (char)in.get();
-
-			// Identifiers we can mark
-			if (ec->is_identifier()) {
-				// Update metrics
-				id_msum.add_pre_cpp_id(ec);
-				// Add to the map
-				Filedetails::get_pre_cpp_metrics(fi).process_identifier(s, ec);
-				if (cfun)
-					cfun->get_pre_cpp_metrics().process_identifier(s, ec);
-				/*
-				 * ids[ec] = Identifier(ec, s);
-				 * Efficiently add s to ids, if needed.
-				 * See Meyers, effective STL, Item 24.
-				 */
-				IdProp::iterator idi = ids.lower_bound(ec);
-				if (idi == ids.end() || idi->first != ec)
-					ids.insert(idi, IdProp::value_type(ec, Identifier(ec, s)));
-				if (ec->is_unused())
-					has_unused = true;
-				else
-					; // TODO fi.set_associated_files(ec);
+			bool remove = rejected || !ec->is_identifier();
+			if (remove && ctx.speculative && first_file(ctx, ec) != fi) {
+				// An earlier file will have removed it
+				r.skipped.push_back(ec);
+			} else if (rejected) {
+				removed_here.insert(ec);
+				r.removed.push_back(ec);
+				continue;
 			} else {
-				/*
-				 * This equivalence class is not needed.
-				 * (All potential identifier tokens,
-				 * even reserved words get an EC. These are
-				 * cleared here.)
-				 */
-				ec->remove_from_tokid_map();
-				delete ec;
-				ec = NULL;
+				string s(1, c);
+				int len = ec->get_len();
+				for (int j = 1; j < len; j++)
+					s += (char)in.get();
+
+				// Identifiers we can mark
+				if (!remove) {
+					// Update metrics
+					r.metrics.process_identifier(s, ec);
+					if (cfun)
+						cfun->process_identifier(s, ec);
+					// Add to the map
+					pair <string, int> &id(r.identifiers[ec]);
+					if (id.second++ == 0)
+						id.first = s;
+					if (ec->is_unused())
+						r.has_unused = true;
+					else
+						; // TODO fi.set_associated_files(ec);
+				} else {
+					// This equivalence class is not needed.
+					// (All potential identifier tokens,
+					// even reserved words get an EC.)
+					removed_here.insert(ec);
+					r.removed.push_back(ec);
+					ec = NULL;
+				}
+				ma_proc.process_ec(ec, s);
 			}
-			ma_proc.process_ec(ec, s);
 		}
-		Filedetails::get_pre_cpp_metrics(fi).process_char((char)val);
+		r.metrics.process_char((char)val);
 		if (cfun)
-			cfun->get_pre_cpp_metrics().process_char((char)val);
+			cfun->process_char((char)val);
 		if (c == '\n') {
-			Filedetails::add_line_end(fi, ti.get_streampos());
+			r.line_ends.push_back(ti.get_streampos());
 			if (!Filedetails::is_line_processed(fi, ++line_number))
-				Filedetails::get_pre_cpp_metrics(fi).add_unprocessed();
+				r.metrics.add_unprocessed();
 		}
 	}
 	if (cfun) {
-		cfun->get_pre_cpp_metrics().summarize_identifiers();
-		if (cfun->is_cfun())
-			cfun->get_pre_cpp_metrics().adjust_cfun_metrics();
+		cfun->summarize_identifiers();
+		if (cfun_call->is_cfun())
+			cfun->adjust_cfun_metrics();
 	}
-	Filedetails::get_pre_cpp_metrics(fi).summarize_identifiers();
-	Filedetails::get_pre_cpp_metrics(fi).set_ncopies(Filedetails::get_identical_files(fi).size());
+	r.metrics.summarize_identifiers();
+	r.metrics.set_ncopies(Filedetails::get_identical_files(fi).size());
 	if (DP())
-		cout << "nchar = " << Filedetails::get_pre_cpp_metrics(fi).get_metric(Metrics::em_nchar) << endl;
+		cout << "nchar = " << r.metrics.get_metric(Metrics::em_nchar) << endl;
 	in.close();
-	return has_unused;
+}
+
+/*
+ * Apply the results of scanning fi to the global state.
+ * If del is true, ECs the file removes are deleted, otherwise
+ * they are added to ctx.removed to be deleted by the caller.
+ */
+static void
+file_commit(Fileid fi, ScanContext &ctx, FileAnalysis &r, bool del)
+{
+	Filedetails::get_pre_cpp_metrics(fi) = r.metrics;
+	for (vector <Call *>::size_type i = 0; i < r.funs.size(); i++) {
+		/*
+		 * The scan doesn't change em_nneparam, but files committed
+		 * after the scan's start may have added to it.
+		 */
+		FunMetrics &m(r.funs[i]->get_pre_cpp_metrics());
+		int nneparam = (int)m.get_metric(FunMetrics::em_nneparam);
+		m = r.fun_metrics[i];
+		m.set_metric(FunMetrics::em_nneparam, nneparam);
+	}
+	for (vector <streampos>::const_iterator i = r.line_ends.begin(); i != r.line_ends.end(); i++)
+		Filedetails::add_line_end(fi, *i);
+	for (map <Eclass *, pair <string, int> >::const_iterator i = r.identifiers.begin(); i != r.identifiers.end(); i++) {
+		id_msum.add_pre_cpp_id(i->first, i->second.second);
+		/*
+		 * ids[ec] = Identifier(ec, s);
+		 * Efficiently add s to ids, if needed.
+		 * See Meyers, effective STL, Item 24.
+		 */
+		IdProp::iterator idi = ids.lower_bound(i->first);
+		if (idi == ids.end() || idi->first != i->first)
+			ids.insert(idi, IdProp::value_type(i->first, Identifier(i->first, i->second.first)));
+	}
+	for (vector <pair <Call *, int> >::const_iterator i = r.nneparam.begin(); i != r.nneparam.end(); i++)
+		i->first->get_pre_cpp_metrics().add_metric(FunMetrics::em_nneparam, i->second);
+	for (vector <Eclass *>::const_iterator i = r.removed.begin(); i != r.removed.end(); i++)
+		if (del) {
+			(*i)->remove_from_tokid_map();
+			delete *i;
+		} else
+			ctx.removed.insert(*i);
+}
+
+// Add identifiers of the file fi into ids
+// Collect metrics for the file and its functions
+// Populate the file's accociated files set
+// Return true if the file contains unused identifiers
+static bool
+file_analyze(Fileid fi)
+{
+	ScanContext ctx;
+	FileAnalysis r;
+
+	ctx.speculative = false;
+	cerr << "Post-processing " << fi.get_path() << endl;
+	file_scan(fi, ctx, r);
+	file_commit(fi, ctx, r, true);
+	return r.has_unused;
+}
+
+/*
+ * Analyze the specified files using the configured number of threads.
+ * The results are the same as calling file_analyze() for each file
+ * in order.
+ * Files are first scanned concurrently, assuming that an EC that
+ * must be removed is removed by the first file containing it.
+ * The scan results are then committed in file order.  A file whose
+ * assumption is found to be wrong (because the EC was not encountered
+ * in the earlier file) is scanned again serially.  Finally,
+ * the removed ECs are deleted.
+ */
+static void
+files_analyze(const vector <Fileid> &files)
+{
+	ScanContext ctx;
+
+	ctx.rank.resize(Fileid::max_id() + 1, files.size());
+	for (vector <Fileid>::size_type i = 0; i < files.size(); i++)
+		ctx.rank[files[i].get_id()] = i;
+
+	vector <FileAnalysis> results(files.size());
+	ctx.speculative = true;
+	Parallel::for_each_index(files.size(), [&](size_t i) {
+		file_scan(files[i], ctx, results[i]);
+	});
+
+	ctx.speculative = false;
+	for (vector <Fileid>::size_type i = 0; i < files.size(); i++) {
+		FileAnalysis &r(results[i]);
+		cerr << "Post-processing " << files[i].get_path() << endl;
+		for (vector <Eclass *>::const_iterator j = r.skipped.begin(); j != r.skipped.end(); j++)
+			if (ctx.removed.find(*j) == ctx.removed.end()) {
+				if (DP())
+					cout << "Rescanning " << files[i].get_path() << endl;
+				r = FileAnalysis();
+				file_scan(files[i], ctx, r);
+				break;
+			}
+		file_commit(files[i], ctx, r, false);
+		r = FileAnalysis();
+	}
+
+	for (set <Eclass *>::const_iterator i = ctx.removed.begin(); i != ctx.removed.end(); i++) {
+		(*i)->remove_from_tokid_map();
+		delete *i;
+	}
 }
 
 // Display the contents of a file in hypertext form
 static void
 file_hypertext(FILE *of, Fileid fi, bool eval_query)
 {
-	istream *in;
 	const string &fname = fi.get_path();
 	bool at_bol = true;
 	int line_number = 1;
@@ -450,84 +631,103 @@ file_hypertext(FILE *of, Fileid fi, bool eval_query)
 
 	if (DP())
 		cout << "Write to " << fname << endl;
-	if (Filedetails::is_hand_edited(fi)) {
-		in = new istringstream(Filedetails::get_original_contents(fi));
-		fputs("<p>This file has been edited by hand. The following code reflects the contents before the first CScout-invoked hand edit.</p>", of);
-	} else {
-		in = new ifstream(fname.c_str(), ios::binary);
-		if (in->fail()) {
-			html_perror(of, "Unable to open " + fname + " for reading");
-			return;
-		}
+	const SourceSpans::Contents *src = SourceSpans::get(fi);
+	if (src == NULL) {
+		html_perror(of, "Unable to open " + fname + " for reading");
+		return;
 	}
+	if (Filedetails::is_hand_edited(fi))
+		fputs("<p>This file has been edited by hand. The following code reflects the contents before the first CScout-invoked hand edit.</p>", of);
 	fputs("<hr><code>", of);
 	(void)html('\n');	// Reset HTML tab handling
-	// Go through the file character by character
-	for (;;) {
-		Tokid ti;
-		int val;
 
-		ti = Tokid(fi, in->tellg());
-		if ((val = in->get()) == EOF)
-			break;
-		if (at_bol) {
-			fprintf(of,"<a name=\"%d\"></a>", line_number);
-			if (mark_unprocessed && !Filedetails::is_line_processed(fi, line_number))
-				fprintf(of, "<span class=\"unused\">");
-			if (Option::show_line_number->get()) {
-				char buff[50];
-				snprintf(buff, sizeof(buff), "%5d ", line_number);
-				// Do not go via HTML string to keep tabs ok
-				for (char *s = buff; *s; s++)
-					if (*s == ' ')
-						fputs("&nbsp;", of);
-					else
-						fputc(*s, of);
+	const string &text = src->text;
+	// Output the start of a line, if needed
+	auto begin_line = [&]() {
+		if (!at_bol)
+			return;
+		fprintf(of,"<a name=\"%d\"></a>", line_number);
+		if (mark_unprocessed && !Filedetails::is_line_processed(fi, line_number))
+			fprintf(of, "<span class=\"unused\">");
+		if (Option::show_line_number->get()) {
+			char buff[50];
+			snprintf(buff, sizeof(buff), "%5d ", line_number);
+			// Do not go via HTML string to keep tabs ok
+			for (char *s = buff; *s; s++)
+				if (*s == ' ')
+					fputs("&nbsp;", of);
+				else
+					fputc(*s, of);
+		}
+		at_bol = false;
+	};
+	// Output the text in [from, to) that is not marked
+	auto plain = [&](size_t from, size_t to) {
+		while (from < to) {
+			begin_line();
+			size_t nl = text.find('\n', from);
+			size_t end = (nl == string::npos || nl >= to) ? to : nl + 1;
+			html_text(of, text.data() + from, end - from);
+			from = end;
+			if (nl != string::npos && end == nl + 1) {
+				at_bol = true;
+				if (mark_unprocessed && !Filedetails::is_line_processed(fi, line_number))
+					fprintf(of, "</span>");
+				line_number++;
 			}
-			at_bol = false;
 		}
-		// Identifier we can mark
-		Eclass *ec;
-		if (have_idq && (ec = ti.check_ec()) && ec->is_identifier() && idq.need_eval()) {
-			string s;
-			s = (char)val;
-			int len = ec->get_len();
-			for (int j = 1; j < len; j++)
-				s += (char)in->get();
-			Identifier i(ec, s);
-			const IdPropElem ip(ec, i);
-			if (idq.eval(ip))
-				html(of, ip);
-			else
-				html_string(of, s);
-			continue;
+	};
+	// Return true if the span [from, from + len) fits within its line
+	auto in_line = [&](size_t from, size_t len) {
+		return from + len <= text.length() && text.find('\n', from) >= from + len;
+	};
+
+	size_t pos = 0;			// Characters output so far
+	if (have_idq && idq.need_eval()) {
+		// Identifiers we can mark
+		for (vector <pair <cs_offset_t, Eclass *> >::const_iterator i = src->identifiers.begin(); i != src->identifiers.end(); i++) {
+			size_t offset = i->first;
+			Eclass *ec = i->second;
+			size_t len = ec->get_len();
+			if (offset < pos || !in_line(offset, len))
+				continue;
+			plain(pos, offset);
+			begin_line();
+			bool match;
+			IdProp::const_iterator idi = ids.find(ec);
+			if (idi != ids.end())
+				match = idq.eval(*idi);
+			else {
+				Identifier id(ec, text.substr(offset, len));
+				match = idq.eval(IdPropElem(ec, id));
+			}
+			if (match)
+				fprintf(of, "<a href=\"id.html?id=%p\">", ec);
+			html_text(of, text.data() + offset, len);
+			if (match)
+				fputs("</a>", of);
+			pos = offset + len;
 		}
-		// Function we can mark
-		if (have_funq && funq.need_eval()) {
-			pair <Call::const_fmap_iterator_type, Call::const_fmap_iterator_type> be(Call::get_calls(ti));
-			Call::const_fmap_iterator_type ci;
-			for (ci = be.first; ci != be.second; ci++)
-				if (funq.eval(ci->second)) {
-					string s;
-					s = (char)val;
-					int len = ci->second->get_name().length();
-					for (int j = 1; j < len; j++)
-						s += (char)in->get();
+	} else if (have_funq && funq.need_eval()) {
+		// Functions we can mark
+		for (vector <cs_offset_t>::const_iterator i = src->funs.begin(); i != src->funs.end(); i++) {
+			size_t offset = *i;
+			if (offset < pos)
+				continue;
+			pair <Call::const_fmap_iterator_type, Call::const_fmap_iterator_type> be(Call::get_calls(Tokid(fi, offset)));
+			for (Call::const_fmap_iterator_type ci = be.first; ci != be.second; ci++) {
+				size_t len = ci->second->get_name().length();
+				if (in_line(offset, len) && funq.eval(ci->second)) {
+					plain(pos, offset);
+					begin_line();
 					html(of, *(ci->second));
+					pos = offset + len;
 					break;
 				}
-			if (ci != be.second)
-				continue;
-		}
-		fprintf(of, "%s", html((char)val));
-		if ((char)val == '\n') {
-			at_bol = true;
-			if (mark_unprocessed && !Filedetails::is_line_processed(fi, line_number))
-				fprintf(of, "</span>");
-			line_number++;
+			}
 		}
 	}
-	delete in;
+	plain(pos, text.length());
 	fputs("<hr></code>", of);
 }
 
@@ -860,7 +1060,7 @@ file_refactor(FILE *of, Fileid fid)
 
 	if (RefFunCall::store.size())
 		establish_argument_boundaries(fid.get_path());
-	in.open(fid.get_path().c_str(), ios::binary);
+	in.open(fid);
 	if (in.fail()) {
 		html_perror(of, "Unable to open " + fid.get_path() + " for reading");
 		return;
@@ -879,6 +1079,9 @@ file_refactor(FILE *of, Fileid fid)
 	// Needed for Windows
 	in.close();
 	out.close();
+	// The file is about to be replaced; unmap it
+	FileView::invalidate(fid);
+	SourceSpans::invalidate(fid);
 
 	if (Option::sfile_re_string->get().length()) {
 		regmatch_t be;
@@ -1312,22 +1515,23 @@ xiquery_page(FILE *of,  void *p)
 	}
 
 	html_head(of, "xiquery", (qname && *qname) ? qname : "Identifier Query Results");
-	cerr << "Evaluating identifier query" << endl;
-	for (IdProp::iterator i = ids.begin(); i != ids.end(); i++) {
-		progress(i, ids);
-		if (!query.eval(*i))
-			continue;
+	// Only evaluate the query on the candidates obtained from the index
+	IdBitset candidates;
+	query.candidates(candidates);
+	candidates.for_each([&](size_t ord) {
+		IdPropElem &i(IdIndex::element(ord));
+		if (!query.eval(i))
+			return;
 		if (q_id)
-			sorted_ids.insert(&*i);
+			sorted_ids.insert(&i);
 		else if (q_file) {
-			IFSet f = i->first->sorted_files();
+			IFSet f = i.first->sorted_files();
 			sorted_files.insert(f.begin(), f.end());
 		} else if (q_fun) {
-			set <Call *> ecfuns(i->first->functions());
+			set <Call *> ecfuns(i.first->functions());
 			funs.insert(ecfuns.begin(), ecfuns.end());
 		}
-	}
-	cerr << endl;
+	});
 	if (q_id) {
 		fputs("<h2>Matching Identifiers</h2>\n", of);
 		display_sorted(of, query, sorted_ids);
@@ -1419,6 +1623,7 @@ identifier_page(FILE *fo, void *p)
 		string ssubst(subst);
 		id.set_newid(ssubst);
 		modification_state = ms_subst;
+		PageCache::invalidate();
 	}
 	html_head(fo, "id", string("Identifier: ") + html(id.get_id()));
 	fprintf(fo, "<FORM ACTION=\"id.html\" METHOD=\"GET\">\n<ul>\n");
@@ -1504,6 +1709,7 @@ function_page(FILE *fo, void *p)
 		prohibit_remote_access(fo);
 		RefFunCall::store.insert(RefFunCall::store_type::value_type(ec, RefFunCall(f, subst)));
 		modification_state = ms_subst;
+		PageCache::invalidate();
 	}
 	html_head(fo, "fun", string("Function: ") + html(f->get_name()) + " (" + f->entity_type_name() + ')');
 	fprintf(fo, "<FORM ACTION=\"fun.html\" METHOD=\"GET\">\n");
@@ -1712,7 +1918,7 @@ visit_globobj_files(Fileid f, const Fileidset & (*get_fileid_set)(Fileid fi),
  * the corresponding edges.
  */
 static void
-visit_fcall_files(Fileid f, Call::const_fiterator_type (Call::*abegin)() const, Call::const_fiterator_type (Call::*aend)() const, int level, EdgeMatrix &edges)
+visit_fcall_files(Fileid f, Call::const_fiterator_type (Call::*abegin)() const, Call::const_fiterator_type (Call::*aend)() const, int level, EdgeMap &edges)
 {
 	if (level == 0)
 		return;
@@ -1731,7 +1937,7 @@ visit_fcall_files(Fileid f, Call::const_fiterator_type (Call::*abegin)() const,
 		for (Call::const_fiterator_type afun = ((*filefun)->*abegin)(); afun != ((*filefun)->*aend)(); afun++)
 			if ((*afun)->is_defined() && (*afun)->is_cfun()) {
 				Fileid f2((*afun)->get_definition().get_fileid());
-				edges[f.get_id()][f2.get_id()] = true;
+				edges[f].insert(f2);
 				if (!Filedetails::is_visited(f2))
 					visit_fcall_files(f2, abegin, aend, level - 1, edges);
 			}
@@ -1842,6 +2048,16 @@ funlist_page(FILE *fo, void *p)
 	if (swill_getvar("e")) {
 		fprintf(fo, "<br />\n");
 		explore_functions(fo, f, fbegin, fend, 0);
+	} else if (recurse && ReachIndex::is_available()) {
+		fprintf(fo, "<ul>\n");
+		ReachIndex::for_each_function(f, *ltype == 'D', [&](Call *c) {
+			if (c == f)
+				return;
+			fprintf(fo, "<li> ");
+			html(fo, *c);
+			fprintf(fo, buff, c);
+		});
+		fprintf(fo, "</ul>\n");
 	} else {
 		fprintf(fo, "<ul>\n");
 		Call::clear_visit_flags();
@@ -1851,45 +2067,6 @@ funlist_page(FILE *fo, void *p)
 	html_tail(fo);
 }
 
-// Display the call paths between functions from and to
-// This should be called once to generate the nodes and a second time
-// to generate the edges
-static bool
-call_path(GraphDisplay *gd, Call *from, Call *to, bool generate_nodes)
-{
-	bool ret = false;
-
-	from->set_visited();
-	if (DP())
-		cout << "From path: from: " << from->get_name() << " to " << to->get_name() << endl;
-	int count = 0;
-	for (Call::const_fiterator_type i = from->call_begin(); i != from->call_end(); i++)
-		if (!(*i)->is_visited() && (*i == to || call_path(gd, *i, to, generate_nodes))) {
-			if (generate_nodes) {
-				if (!from->is_printed()) {
-					gd->node(from);
-					from->set_printed();
-					if (browse_only && count++ >= MAX_BROWSING_GRAPH_ELEMENTS)
-						break;
-				}
-				if (!(*i)->is_printed()) {
-					gd->node(*i);
-					(*i)->set_printed();
-					if (browse_only && count++ >= MAX_BROWSING_GRAPH_ELEMENTS)
-						break;
-				}
-			} else {
-				gd->edge(from, *i);
-				if (browse_only && count++ >= MAX_BROWSING_GRAPH_ELEMENTS)
-					break;
-			}
-			ret = true;
-		}
-	if (DP())
-		cout << "Returns " << ret << endl;
-	return (ret);
-}
-
 // List the call graph from one function to another
 static void
 cpath_page(GraphDisplay *gd)
@@ -1909,11 +2086,20 @@ cpath_page(GraphDisplay *gd)
 	    function_label(from, true) +
 	    string(" &rarr; ") +
 	    function_label(to, true));
-	Call::clear_print_flags();
-	Call::clear_visit_flags();
-	call_path(gd, from, to, true);
-	Call::clear_visit_flags();
-	call_path(gd, from, to, false);
+	CallPath path(from, to, (size_t)Option::cpath_visits->get() * 1000);
+	if (path.get_result() == CallPath::cp_budget)
+		gd->error("Too many functions visited; increase the call path search limit");
+	int count = 0;
+	for (CallPath::Nodes::const_iterator i = path.get_nodes().begin(); i != path.get_nodes().end(); i++) {
+		gd->node(*i);
+		if (browse_only && count++ >= MAX_BROWSING_GRAPH_ELEMENTS)
+			break;
+	}
+	for (CallPath::Edges::const_iterator i = path.get_edges().begin(); i != path.get_edges().end(); i++) {
+		gd->edge(i->first, i->second);
+		if (browse_only && count++ >= MAX_BROWSING_GRAPH_ELEMENTS)
+			break;
+	}
 	gd->tail();
 }
 
@@ -1943,6 +2129,7 @@ set_options_page(FILE *fo, void *p)
 		return;
 	}
 	Option::set_all();
+	PageCache::invalidate();
 	if (Option::sfile_re_string->get().length()) {
 		sfile_re = CompiledRE(Option::sfile_re_string->get().c_str(), REG_EXTENDED);
 		if (!sfile_re.isCorrect()) {
@@ -2032,6 +2219,234 @@ id_metrics_page(FILE *fo, void *p)
 	html_tail(fo);
 }
 
+/*
+ * The JSON API pages.
+ * Elements are returned in their internal order, rather than sorted,
+ * so that output can start with the first matching element.
+ * Each response contains at most limit elements (by default the
+ * number of entries per page) and a cursor; passing the cursor
+ * as the cursor parameter returns the following elements.
+ * Elements are filtered through the parameters of the corresponding
+ * HTML query forms; without a match parameter all elements are returned.
+ */
+
+/*
+ * Set the HTTP headers of a JSON response, and obtain the
+ * requested number of elements in limit.
+ */
+static void
+json_head(int &limit)
+{
+	swill_setheader("Content-Type", "application/json");
+	if (!swill_getargs("i(limit)", &limit) || limit <= 0)
+		limit = Option::entries_per_page->get();
+}
+
+/*
+ * Output a JSON error for a query that was not valid, with
+ * the messages its construction wrote to err.
+ */
+static void
+json_query_error(FILE *of, FILE *err)
+{
+	string msg;
+	long len = ftell(err);
+	if (len > 0) {
+		msg.resize(len);
+		rewind(err);
+		msg.resize(fread(&msg[0], 1, len, err));
+	}
+	json_error(of, msg.empty() ? "Invalid query" : msg);
+}
+
+// Output the cursor that follows a page of elements; empty if none
+static void
+json_tail(FILE *of, const string &cursor)
+{
+	fprintf(of, "],\n\"next\": %s}\n", cursor.empty() ? "null" : json(cursor).c_str());
+}
+
+// Identifiers, starting from their ordinal in the identifier index
+static void
+api_ids_page(FILE *of, void *p)
+{
+	prohibit_remote_access(of);
+	int limit;
+	json_head(limit);
+
+	FILE *err = tmpfile();
+	if (err == NULL) {
+		json_error(of, "Unable to create temporary file");
+		return;
+	}
+	IdQuery query(err, Option::file_icase->get(), current_project);
+	bool filtered = swill_getvar("match") || swill_getvar("ec");
+	if (filtered && !query.is_valid()) {
+		json_query_error(of, err);
+		fclose(err);
+		return;
+	}
+	fclose(err);
+
+	IdBitset candidates;
+	if (filtered)
+		query.candidates(candidates);
+	else {
+		candidates = IdBitset(IdIndex::size(), true);
+		if (current_project)
+			candidates &= IdIndex::attribute(current_project);
+	}
+
+	int cursor;
+	if (!swill_getargs("i(cursor)", &cursor) || cursor < 0)
+		cursor = 0;
+	fputs("{\"ids\": [\n", of);
+	int n = 0;
+	size_t ord;
+	for (ord = candidates.next(cursor); ord != IdBitset::npos; ord = candidates.next(ord + 1)) {
+		IdPropElem &i(IdIndex::element(ord));
+		if (filtered && !query.eval(i))
+			continue;
+		if (n == limit)
+			break;
+		Eclass *e = i.first;
+		fprintf(of, "%s{\"ec\": \"%p\", \"name\": %s, \"occurrences\": %d, "
+		    "\"readonly\": %s, \"xfile\": %s, \"unused\": %s}",
+		    n++ ? ",\n" : "", e, json(i.second.get_id()).c_str(), e->get_size(),
+		    e->get_attribute(is_readonly) ? "true" : "false",
+		    i.second.get_xfile() ? "true" : "false",
+		    e->is_unused() ? "true" : "false");
+	}
+	json_tail(of, ord == IdBitset::npos ? "" : to_string(ord));
+}
+
+// Functions, starting from the token of their name
+static void
+api_funs_page(FILE *of, void *p)
+{
+	prohibit_remote_access(of);
+	int limit;
+	json_head(limit);
+
+	FILE *err = tmpfile();
+	if (err == NULL) {
+		json_error(of, "Unable to create temporary file");
+		return;
+	}
+	FunQuery query(err, Option::file_icase->get(), current_project);
+	bool filtered = swill_getvar("match") || swill_getvar("ec");
+	if (filtered && !query.is_valid()) {
+		json_query_error(of, err);
+		fclose(err);
+		return;
+	}
+	fclose(err);
+	bool metrics = !!swill_getvar("metrics");
+
+	// The cursor is the Fileid and offset of the function's token
+	Call::const_fmap_iterator_type i = Call::fbegin();
+	char *cursor = swill_getvar("cursor");
+	int fid;
+	unsigned long offset;
+	if (cursor && sscanf(cursor, "%d.%lu", &fid, &offset) == 2)
+		i = Call::functions().lower_bound(Tokid(Fileid(fid), offset));
+
+	fputs("{\"funs\": [\n", of);
+	int n = 0;
+	Tokid last;			// Token of the last output function
+	for (; i != Call::fend(); i++) {
+		Call *c = i->second;
+		if (filtered) {
+			if (!query.eval(c))
+				continue;
+		} else if (current_project && !c->get_tokid().get_ec()->get_attribute(current_project))
+			continue;
+		// Stop on a token boundary, so that the cursor can resume from it
+		if (n >= limit && i->first != last)
+			break;
+		last = i->first;
+		fprintf(of, "%s{\"call\": \"%p\", \"name\": %s, \"file\": %s, "
+		    "\"defined\": %s, \"macro\": %s",
+		    n++ ? ",\n" : "", c, json(c->get_name()).c_str(),
+		    json(c->get_fileid().get_path()).c_str(),
+		    c->is_defined() ? "true" : "false",
+		    c->is_macro() ? "true" : "false");
+		if (metrics) {
+			fputs(", \"metrics\": ", of);
+			json_metrics(of, c->get_pre_cpp_const_metrics(), c->get_post_cpp_const_metrics());
+		}
+		fputs("}", of);
+	}
+	json_tail(of, i == Call::fend() ? "" :
+	    to_string(i->first.get_fileid().get_id()) + '.' +
+	    to_string((unsigned long)i->first.get_streampos()));
+}
+
+// Files, starting from their position in the list of files sorted by name
+static void
+api_files_page(FILE *of, void *p)
+{
+	prohibit_remote_access(of);
+	int limit;
+	json_head(limit);
+
+	FILE *err = tmpfile();
+	if (err == NULL) {
+		json_error(of, "Unable to create temporary file");
+		return;
+	}
+	FileQuery query(err, Option::file_icase->get(), current_project);
+	bool filtered = !!swill_getvar("match");
+	if (filtered && !query.is_valid()) {
+		json_query_error(of, err);
+		fclose(err);
+		return;
+	}
+	fclose(err);
+	bool metrics = !!swill_getvar("metrics");
+
+	int cursor;
+	if (!swill_getargs("i(cursor)", &cursor) || cursor < 0)
+		cursor = 0;
+	fputs("{\"files\": [\n", of);
+	int n = 0;
+	vector <Fileid>::size_type pos;
+	for (pos = cursor; pos < files.size(); pos++) {
+		Fileid f = files[pos];
+		if (filtered && !query.eval(f))
+			continue;
+		if (current_project && !Filedetails::get_attribute(f, current_project))
+			continue;
+		if (n == limit)
+			break;
+		fprintf(of, "%s{\"fid\": %d, \"path\": %s, \"readonly\": %s",
+		    n++ ? ",\n" : "", f.get_id(), json(f.get_path()).c_str(),
+		    f.get_readonly() ? "true" : "false");
+		if (metrics) {
+			fputs(", \"metrics\": ", of);
+			json_metrics(of, Filedetails::get_pre_cpp_const_metrics(f),
+			    Filedetails::get_post_cpp_const_metrics(f));
+		}
+		fputs("}", of);
+	}
+	json_tail(of, pos < files.size() ? to_string(pos) : "");
+}
+
+// Summaries of the file and function metrics
+static void
+api_metrics_page(FILE *of, void *p)
+{
+	int limit;
+	json_head(limit);
+	fputs("{\"files\": {\"writable\": ", of);
+	json_metrics(of, file_msum.get_writable());
+	fputs(",\n\"readonly\": ", of);
+	json_metrics(of, file_msum.get_readonly());
+	fputs("},\n\"functions\": ", of);
+	json_metrics(of, fun_msum.get_range());
+	fputs("}\n", of);
+}
+
 /*
  * Return true if the call graph is specified for a single function.
  * In this case only show entries that have the visited flag set
@@ -2066,10 +2481,10 @@ single_function_graph()
  * Return true if the include/global/call graph is specified for a single file.
  * In this case caller will only show entries that have the visited flag set, so
  * set this flag as specified.
- * For function * call graphs also fill edges with a matrix indicating the dges to draw
+ * For function * call graphs also fill edges with the edges to draw
  */
 static bool
-single_file_graph(char gtype, EdgeMatrix &edges)
+single_file_graph(char gtype, EdgeMap &edges)
 {
 	int id;
 	char *ltype = swill_getvar("n");
@@ -2110,8 +2525,6 @@ single_file_graph(char gtype, EdgeMatrix &edges)
 		}
 		break;
 	case 'F':		// Function call graph (control dependency)
-		int size = Fileid::max_id() + 1;
-		edges.insert(edges.begin(), size, vector<bool>(size, 0));
 		switch (*ltype) {
 		case 'D':
 			visit_fcall_files(fileid, &Call::call_begin, &Call::call_end, Option::cgraph_depth->get(), edges);
@@ -2216,7 +2629,7 @@ fgraph_page(GraphDisplay *gd)
 		return;
 	}
 	bool all, only_visited;
-	EdgeMatrix edges;
+	EdgeMap edges;
 	bool empty_node = (Option::fgraph_show->get() == 'e');
 	if (gd->uses_swill) {
 		all = !!swill_getvar("all");		// Otherwise exclude read-only files
@@ -2240,8 +2653,6 @@ fgraph_page(GraphDisplay *gd)
 	case 'F':		// Function call graph (control dependency)
 		gd->head("fgraph", "Function Call (Control) Dependency Graph", empty_node);
 		if (!only_visited) {
-			int size = Fileid::max_id() + 1;
-			edges.insert(edges.begin(), size, vector<bool>(size, 0));
 			// Fill the edges for all files
 			Filedetails::clear_all_visited();
 			for (vector <Fileid>::iterator i = files.begin(); i != files.end(); i++) {
@@ -2302,29 +2713,30 @@ fgraph_page(GraphDisplay *gd)
 			}
 			break;
 		}
-		case 'F':		// Function call graph (control dependency)
-			for (vector <Fileid>::iterator j = files.begin(); j != files.end(); j++) {
+		case 'F': {		// Function call graph (control dependency)
+			EdgeMap::const_iterator e = edges.find(*i);
+			if (e == edges.end())
+				break;
+			for (IFSet::const_iterator j = e->second.begin(); j != e->second.end(); j++) {
 				if (!all && j->get_readonly())
 					continue;
 				if (only_visited && !Filedetails::is_visited(*j))
 					continue;
 				if (*i == *j)
 					continue;
-				if (DP())
-					cout << "Checking " << i->get_fname() << " - " << j->get_fname() << endl;
-				if (edges[i->get_id()][j->get_id()])
-					switch (*ltype) {
-					case 'D':
-						gd->edge(*j, *i);
-						break;
-					case 'U':
-						gd->edge(*i, *j);
-						break;
-					}
+				switch (*ltype) {
+				case 'D':
+					gd->edge(*j, *i);
+					break;
+				case 'U':
+					gd->edge(*i, *j);
+					break;
+				}
 				if (browse_only && count++ >= MAX_BROWSING_GRAPH_ELEMENTS)
 					goto end;
 			}
 			break;
+		}
 		case 'G':		// Global object def/ref graph (data dependency)
 			for (Fileidset::const_iterator j = Filedetails::get_glob_uses(*i).begin(); j != Filedetails::get_glob_uses(*i).end(); j++) {
 				if (!all && j->get_readonly())
@@ -2507,17 +2919,43 @@ static void produce_call_graphs(const vector <string> &call_graphs)
 }
 
 
+// A page handler whose output is kept in the page cache
+struct CachedPage {
+	string name;
+	void (*handler)(FILE *, void *);
+	void *data;
+	CachedPage(const string &n, void (*h)(FILE *, void *), void *d) :
+		name(n), handler(h), data(d) {}
+};
+
+// Serve a page through the page cache
+static void
+cached_page(FILE *of, void *p)
+{
+	CachedPage *c = (CachedPage *)p;
+	PageCache::serve(of, c->name.c_str(), swill_getquerystring(),
+	    [c](FILE *f) { c->handler(f, c->data); });
+}
+
+// Setup the handling of a page whose output can be cached
+static void
+cached_handle(const string &name, void (*handler)(FILE *, void *), void *data)
+{
+	swill_handle(name.c_str(), cached_page, new CachedPage(name, handler, data));
+}
+
 // Setup graph handling for all supported graph output types
 static void
 graph_handle(string name, void (*graph_fun)(GraphDisplay *))
 {
-	swill_handle((name + ".html").c_str(), graph_html_page, graph_fun);
-	swill_handle((name + ".txt").c_str(), graph_txt_page, graph_fun);
-	swill_handle((name + "_dot.txt").c_str(), graph_dot_page, graph_fun);
-	swill_handle((name + ".svg").c_str(), graph_svg_page, graph_fun);
-	swill_handle((name + ".gif").c_str(), graph_gif_page, graph_fun);
-	swill_handle((name + ".png").c_str(), graph_png_page, graph_fun);
-	swill_handle((name + ".pdf").c_str(), graph_pdf_page, graph_fun);
+	typedef void (*handler_type)(FILE *, void *);
+	cached_handle(name + ".html", (handler_type)graph_html_page, (void *)graph_fun);
+	cached_handle(name + ".txt", (handler_type)graph_txt_page, (void *)graph_fun);
+	cached_handle(name + "_dot.txt", (handler_type)graph_dot_page, (void *)graph_fun);
+	cached_handle(name + ".svg", (handler_type)graph_svg_page, (void *)graph_fun);
+	cached_handle(name + ".gif", (handler_type)graph_gif_page, (void *)graph_fun);
+	cached_handle(name + ".png", (handler_type)graph_png_page, (void *)graph_fun);
+	cached_handle(name + ".pdf", (handler_type)graph_pdf_page, (void *)graph_fun);
 }
 
 // Display all projects, allowing user to select
@@ -2544,6 +2982,7 @@ set_project_page(FILE *fo, void *p)
 		fprintf(fo, "Missing value");
 		return;
 	}
+	PageCache::invalidate();
 	index_page(fo, p);
 }
 
@@ -2845,6 +3284,9 @@ fedit_page(FILE *of, void *p)
 	}
 	Fileid i(id);
 	Filedetails::set_hand_edited(i);
+	// Do not let the editor's changes appear through a stale mapping
+	FileView::invalidate(i);
+	SourceSpans::invalidate(i);
 	char *re = swill_getvar("re");
 	char buff[4096];
 	snprintf(buff, sizeof(buff), Option::start_editor_cmd ->get().c_str(), (re ? re : "^"), i.get_path().c_str());
@@ -2857,6 +3299,7 @@ fedit_page(FILE *of, void *p)
 	fprintf(of, "The editor should have started in a separate window");
 	html_tail(of);
 	modification_state = ms_hand_edit;
+	PageCache::invalidate();
 }
 
 void
@@ -2985,6 +3428,7 @@ xreplacements_page(FILE *of,  void *p)
 		}
 	}
 	cerr << endl;
+	PageCache::invalidate();
 	index_page(of, p);
 }
 
@@ -3030,6 +3474,7 @@ xfunargrefs_page(FILE *of,  void *p)
 		snprintf(varname, sizeof(varname), "a%p", i->first);
 		i->second.set_active(!!swill_getvar(varname));
 	}
+	PageCache::invalidate();
 	index_page(of, p);
 }
 
@@ -3069,21 +3514,21 @@ write_quit_page(FILE *of, void *exit)
 	cerr << endl;
 
 	// Check for identifier clashes
-	Token::found_clashes = false;
+	bool found_clashes = false;
 	if (Option::refactor_check_clashes->get() && process.size()) {
-		cerr << "Checking rename refactorings for name clashes." << endl;
-		Token::check_clashes = true;
-		// Reparse everything
-		Fchar::set_input(input_file_id.get_path());
-		Error::set_parsing(true);
-		Pdtoken t;
-		do
-			t.getnext();
-		while (t.get_code() != EOF);
-		Error::set_parsing(false);
-		Token::check_clashes = false;
+		if (ClashCheck::is_enabled()) {
+			cerr << "Checking rename refactorings for name clashes." << endl;
+			found_clashes = ClashCheck::check();
+		} else
+			/*
+			 * @error
+			 * The option for checking rename refactorings for
+			 * name clashes was set after the workspace was
+			 * processed, so the names it needs were not recorded.
+			 */
+			Error::error(E_WARN, "name clashes were not checked; the refactor_check_clashes option must be set before processing the workspace", false);
 	}
-	if (Token::found_clashes) {
+	if (found_clashes) {
 		fprintf(of, "Renamed identifier clashes detected. Errors reported on console output. No files were saved.");
 		html_tail(of);
 		return;
@@ -3104,6 +3549,7 @@ write_quit_page(FILE *of, void *exit)
 	cerr << "Processing files" << endl;
 	for (IFSet::const_iterator i = process.begin(); i != process.end(); i++)
 		file_refactor(of, *i);
+	PageCache::invalidate();
 	fprintf(of, "A total of %d replacements and %d function call refactorings were made in %d files.",
 	    num_id_replacements, num_fun_call_refactorings, (unsigned)(process.size()));
 	if (exit) {
@@ -3273,7 +3719,7 @@ usage(char *fname)
 #endif
 		"-C|-c|-d D|-d H|-E RE|-o|-M files|"
 		"-R URL|-r|-S db|-s db|-v] "
-		"[-l file] "
+		"[-H hash] [-j n] [-l file] "
 
 #ifdef PICO_QL
 #define PICO_QL_OPTIONS "q"
@@ -3282,7 +3728,7 @@ usage(char *fname)
 #define PICO_QL_OPTIONS ""
 #endif
 
-		"[-P RE] [-p port] [-m spec] [-t table ...] file\n"
+		"[-P RE] [-p port] [-m spec] [-T file] [-t table ...] [-x] file\n"
 #ifndef WIN32
 		"\t-b\tRun in multiuser browse-only mode\n"
 #endif
@@ -3293,6 +3739,10 @@ usage(char *fname)
 		"\t-d H\tOutput the names of included files being processed\n"
 		"\t-E RE\tOutput preprocessed results and exit\n"
 		"\t\t(Will process file(s) matched by the regular expression)\n"
+		"\t-H hash\tUse the specified algorithm for hashing file contents\n"
+		"\t\t(One of: " + ContentHash::algorithms() + ")\n"
+		"\t-j n\tUse n threads for post-processing and dumping the files\n"
+		"\t\tand n processes for serving browse-only (-b) requests\n"
 		"\t-l file\tSpecify access log file\n"
 		"\t-M files\tMerge specified EC files\n"
 		"\t-m spec\tSpecify identifiers to monitor (unsound)\n"
@@ -3306,9 +3756,18 @@ usage(char *fname)
 		"\t-r\tGenerate an identifier and include file warning report\n"
 		"\t-S db\tGenerate the SQL schema for the specified RDBMS\n"
 		"\t-s db\tGenerate SQL output for the specified RDBMS\n"
+		"\t\t(Append :multirow, :csv (not hsqldb), or :copy (postgres) to db\n"
+		"\t\tfor bulk-loading output)\n"
+#ifdef SQLITE_WRITER
+		"\t\t(Append :db=file to sqlite to write directly into\n"
+		"\t\tthe specified database file)\n"
+#endif
+		"\t-T file\tSave a profile of the processing phases and units\n"
+		"\t\tin the specified CSV file\n"
 		"\t-t table\tEnable population of the specified RDBMS table\n"
 		"\t\t(All enabled by default. Option can be provided multiple times)\n"
 		"\t-v\tDisplay version and copyright information and exit\n"
+		"\t-x\tIndex the transitive closure of the call graph\n"
 		"\t-3\tEnable the handling of trigraph characters\n"
 		;
 	exit(1);
@@ -3360,6 +3819,73 @@ merge_tokens(char **argv)
 	exit(0);
 }
 
+#ifndef WIN32
+/*
+ * Serve browse-only requests from n worker processes accepting
+ * connections on the shared listening socket.
+ * Swill keeps the state of the request it serves in global variables,
+ * so requests cannot be served by threads of a single process.
+ * The workers share the analysis results with the parent as
+ * copy-on-write pages.  Unlike the forking of a process for each
+ * request, a worker incurs the cost of copying the pages it modifies
+ * only once, and a long-running request ties up only one worker.
+ * Over time each worker copies the pages its requests modify, so a
+ * worker exits after serving worker_requests requests, returning its
+ * copies to the system, and is then replaced.
+ * Workers also exit when the parent process terminates.
+ */
+static void
+serve_workers(int n)
+{
+	const int worker_requests = 1000;
+	pid_t parent = getpid();
+	set <pid_t> workers;
+
+	cerr << "Serving requests with " << n << " worker processes" << endl;
+	for (;;) {
+		while ((int)workers.size() < n) {
+			// Do not let workers output the parent's buffered data
+			fflush(NULL);
+			pid_t pid = fork();
+			switch (pid) {
+			case -1:
+				/*
+				 * @error
+				 * A worker process for serving browse-only
+				 * requests could not be created.
+				 */
+				Error::error(E_FATAL, string("fork: ") + strerror(errno), false);
+				break;
+			case 0:
+#ifdef __linux__
+				prctl(PR_SET_PDEATHSIG, SIGTERM);
+#endif
+				/*
+				 * Where the parent's termination is not signalled,
+				 * it is detected after the next request.
+				 */
+				for (int i = 0; i < worker_requests && getppid() == parent; i++)
+					swill_serve();
+				// Flush the access log, without running the destructors
+				fflush(NULL);
+				_exit(0);
+			default:
+				workers.insert(pid);
+				break;
+			}
+		}
+		int status;
+		pid_t pid = wait(&status);
+		if (pid == -1) {
+			if (errno == EINTR)
+				continue;
+			return;
+		}
+		workers.erase(pid);
+	}
+}
+#endif
+
 int
 main(int argc, char *argv[])
 {
@@ -3373,7 +3899,7 @@ main(int argc, char *argv[])
 	vector<string> call_graphs;
 	Debug::db_read();
 
-	while ((c = getopt(argc, argv, "3bCcd:rvE:P:p:Mm:l:oR:S:s:t:" PICO_QL_OPTIONS)) != EOF)
+	while ((c = getopt(argc, argv, "3bCcd:rvE:H:j:P:p:Mm:l:oR:S:s:T:t:x" PICO_QL_OPTIONS)) != EOF)
 		switch (c) {
 		case '3':
 			Fchar::enable_trigraphs();
@@ -3412,6 +3938,20 @@ main(int argc, char *argv[])
 				usage(argv[0]);
 			}
 			break;
+		case 'H':
+			if (!optarg || !ContentHash::set_algorithm(optarg))
+				usage(argv[0]);
+			break;
+		case 'T':
+			if (!optarg)
+				usage(argv[0]);
+			Profiler::enable(optarg);
+			break;
+		case 'j':
+			if (!optarg || atoi(optarg) < 1)
+				usage(argv[0]);
+			Parallel::set_jobs(atoi(optarg));
+			break;
 		case 'p':
 			if (!optarg)
 				usage(argv[0]);
@@ -3438,6 +3978,9 @@ main(int argc, char *argv[])
 		case 'b':
 			browse_only = true;
 			break;
+		case 'x':
+			ReachIndex::enable();
+			break;
 		case 'l':
 			if (!optarg)
 				usage(argv[0]);
@@ -3514,10 +4057,16 @@ main(int argc, char *argv[])
 	if (process_mode == pm_database) {
 		if (!Sql::setEngine(db_engine))
 			return 1;
-		cout << Sql::getInterface()->begin_commands();
-		workdb_schema(Sql::getInterface(), cout);
+		ostringstream schema;
+		workdb_schema(Sql::getInterface(), schema);
+		Sql::getInterface()->begin_data(cout, schema.str());
 	}
 
+	// Record the symbol scopes for checking rename refactorings
+	if (process_mode == pm_unspecified && !browse_only &&
+	    Option::refactor_check_clashes->get())
+		ClashCheck::enable();
+
 	Project::set_current_project("unspecified");
 
 	// Set the contents of the master file as immutable
@@ -3525,6 +4074,7 @@ main(int argc, char *argv[])
 	fi.set_readonly(true);
 
 	// Pass 1: process master file loop
+	Profiler::phase("process");
 	Fchar::set_input(argv[optind]);
 	Error::set_parsing(true);
 	do
@@ -3537,6 +4087,7 @@ main(int argc, char *argv[])
 
 	input_file_id = Fileid(argv[optind]);
 
+	Profiler::phase("unify_identical_files");
 	Filedetails::unify_identical_files();
 
 	if (process_mode == pm_obfuscation)
@@ -3565,13 +4116,21 @@ main(int argc, char *argv[])
 	 * Populate the EC identifier member and the directory tree.
 	 * Set several file and function metrics.
 	 */
+	Profiler::phase("analyze_files");
+	Filedetails::index_functions();
 	Call::populate_macro_map();
-	for (vector <Fileid>::iterator i = files.begin(); i != files.end(); i++) {
-		file_analyze(*i);
-		dir_add_file(*i);
-	}
+	if (Parallel::is_enabled()) {
+		files_analyze(files);
+		for (vector <Fileid>::iterator i = files.begin(); i != files.end(); i++)
+			dir_add_file(*i);
+	} else
+		for (vector <Fileid>::iterator i = files.begin(); i != files.end(); i++) {
+			file_analyze(*i);
+			dir_add_file(*i);
+		}
 
 	// Update file and function metrics
+	Profiler::phase("summarize");
 	file_msum.summarize_files();
 	fun_msum.summarize_functions();
 
@@ -3579,6 +4138,7 @@ main(int argc, char *argv[])
 	GlobObj::set_file_dependencies();
 
 	// Set xfile and  metrics for each identifier
+	Profiler::phase("process_identifiers");
 	cerr << "Processing identifiers" << endl;
 	for (IdProp::iterator i = ids.begin(); i != ids.end(); i++) {
 		progress(i, ids);
@@ -3594,9 +4154,12 @@ main(int argc, char *argv[])
 		cout << "Size " << file_msum.get_pre_cpp_total(Metrics::em_nchar) << endl;
 
 	if (process_mode == pm_database) {
+		Profiler::phase("dump");
 		workdb_rest(Sql::getInterface(), cout);
 		Call::dumpSql(Sql::getInterface(), cout);
-		cout << Sql::getInterface()->end_commands();
+		ostringstream indexes;
+		workdb_indexes(indexes);
+		Sql::getInterface()->end_data(cout, indexes.str());
 #ifdef LINUX_STAT_MONITOR
 		char buff[100];
 		sprintf(buff, "cat /proc/%u/stat >%u.stat", getpid(), getpid());
@@ -3609,30 +4172,34 @@ main(int argc, char *argv[])
 	}
 
 	if (process_mode != pm_compile) {
-		swill_handle("src.html", source_page, NULL);
-		swill_handle("qsrc.html", query_source_page, NULL);
+		cached_handle("src.html", source_page, NULL);
+		cached_handle("qsrc.html", query_source_page, NULL);
 		swill_handle("fedit.html", fedit_page, NULL);
 		swill_handle("file.html", file_page, NULL);
 		swill_handle("dir.html", dir_page, NULL);
 
 		// Identifier query and execution
 		swill_handle("iquery.html", iquery_page, NULL);
-		swill_handle("xiquery.html", xiquery_page, NULL);
+		cached_handle("xiquery.html", xiquery_page, NULL);
 		// File query and execution
 		swill_handle("filequery.html", filequery_page, NULL);
-		swill_handle("xfilequery.html", xfilequery_page, NULL);
+		cached_handle("xfilequery.html", xfilequery_page, NULL);
 		swill_handle("qinc.html", query_include_page, NULL);
 
 		// Function query and execution
 		swill_handle("funquery.html", funquery_page, NULL);
-		swill_handle("xfunquery.html", xfunquery_page, NULL);
+		cached_handle("xfunquery.html", xfunquery_page, NULL);
 
 		swill_handle("id.html", identifier_page, NULL);
 		swill_handle("fun.html", function_page, NULL);
 		swill_handle("funlist.html", funlist_page, NULL);
-		swill_handle("funmetrics.html", function_metrics_page, NULL);
-		swill_handle("filemetrics.html", file_metrics_page, NULL);
-		swill_handle("idmetrics.html", id_metrics_page, NULL);
+		cached_handle("funmetrics.html", function_metrics_page, NULL);
+		cached_handle("filemetrics.html", file_metrics_page, NULL);
+		cached_handle("idmetrics.html", id_metrics_page, NULL);
+		swill_handle("api/ids", api_ids_page, NULL);
+		swill_handle("api/funs", api_funs_page, NULL);
+		swill_handle("api/files", api_files_page, NULL);
+		swill_handle("api/metrics", api_metrics_page, NULL);
 
 		graph_handle("cgraph", cgraph_page);
 		graph_handle("fgraph", fgraph_page);
@@ -3666,10 +4233,13 @@ main(int argc, char *argv[])
 	if (pico_ql) {
 		pico_ql_register(&files, "files");
 		pico_ql_register(&Identifier::ids, "ids");
-		pico_ql_register(&Tokid::tm, "tm");
+		static mapTokidEclass tm;
+		pico_ql_register(&tm, "tm");
 		pico_ql_register(&Call::functions(), "fun_map");
-		while (pico_ql_serve(portno))
-			;
+		// The ordered map is a copy; refresh it before each query
+		do
+			tm = Tokid::ordered_map();
+		while (pico_ql_serve(portno));
 		return (0);
 	}
 #endif
@@ -3687,13 +4257,30 @@ main(int argc, char *argv[])
 		cout  << "Tokid EC map size is " << Tokid::map_size() << endl;
 	if (process_mode == pm_compile)
 		return (0);
+	// Build the identifier query index before any request forks a server
+	Profiler::phase("index_identifiers");
+	IdIndex::build();
+	// Only the web pages query the reachability index
+	if (ReachIndex::is_enabled()) {
+		Profiler::phase("index_reachability");
+		ReachIndex::build();
+	}
+
 	// Serve web pages
 	if (!must_exit)
 		cerr << "CScout is now ready to serve you at http://localhost:" << portno << endl;
-	if (browse_only)
-		swill_setfork();
-	while (!must_exit)
-		swill_serve();
+	Profiler::phase("serve");
+#ifndef WIN32
+	if (browse_only && Parallel::is_enabled())
+		serve_workers(Parallel::get_jobs());
+	else
+#endif
+	{
+		if (browse_only)
+			swill_setfork();
+		while (!must_exit)
+			swill_serve();
+	}
 
 #ifdef NODE_USE_PROFILE
 	cout << "Type node count = " << Type_node::get_count() << endl;
@@ -3739,7 +4326,7 @@ garbage_collect(Fileid root)
 		const string &fname = fi.get_path();
 		fifstream in;
 
-		in.open(fname.c_str(), ios::binary);
+		in.open(fi);
 		if (in.fail()) {
 			perror(fname.c_str());
 			exit(1);
@@ -3752,10 +4339,9 @@ garbage_collect(Fileid root)
 			ti = Tokid(fi, in.tellg());
 			if ((val = in.get()) == EOF)
 				break;
-			mapTokidEclass::iterator ei = ti.find_ec();
-			if (ei != ti.end_ec()) {
+			Eclass *ec = ti.check_ec();
+			if (ec != NULL) {
 				sum++;
-				Eclass *ec = ei->second;
 				IdPropElem ec_id(ec, Identifier());
 				if (!monitor.eval(ec_id)) {
 					count++;
@@ -47,6 +47,8 @@
 #include "macro.h"
 #include "pdtoken.h"
 #include "ctoken.h"
+#include "keyword.h"
+#include "ckeywords.h"
 #include "type.h"
 #include "stab.h"
 #include "call.h"
@@ -128,66 +130,8 @@ unescape_char(const string& s, string::const_iterator& si)
 	}
 }
 
-// Create the map from identifiers to keyword token values
-static map<string,int> &
-make_keymap()
-{
-	static map<string,int> m;
-
-	m["auto"] = AUTO; m["double"] = DOUBLE; m["int"] = INT;
-	m["struct"] = STRUCT; m["break"] = BREAK; m["else"] = ELSE;
-	m["long"] = LONG; m["switch"] = SWITCH; m["case"] = CASE;
-	m["enum"] = ENUM; m["register"] = REGISTER; m["typedef"] = TYPEDEF;
-	m["char"] = CHAR; m["extern"] = EXTERN; m["return"] = RETURN;
-	m["union"] = UNION; m["const"] = TCONST; m["float"] = FLOAT;
-	m["short"] = SHORT; m["unsigned"] = UNSIGNED; m["continue"] = CONTINUE;
-	m["for"] = FOR; m["signed"] = SIGNED; m["void"] = TVOID;
-	m["default"] = DEFAULT; m["goto"] = GOTO; m["sizeof"] = SIZEOF;
-	m["volatile"] = VOLATILE; m["do"] = DO; m["if"] = IF;
-	m["static"] = STATIC; m["while"] = WHILE;
-	/* C99 */
-	m["inline"] = INLINE;
-	m["restrict"] = RESTRICT;
-	m["_Bool"] = BOOL;
-	m["_Complex"] = COMPLEX;
-	m["_Imaginary"] = IMAGINARY;
-	/* C11 */
-	m["_Thread_local"] = THREAD_LOCAL;
-	m["_Generic"] = GENERIC;
-
-	/* Microsoft */
-	m["_asm"] = MSC_ASM;
-	m["__try"] = TRY;
-	m["__except"] = EXCEPT;
-	m["__finally"] = FINALLY;
-	m["__leave"] = LEAVE;
-	/* gcc; from c-parse.in */
-	m["__asm"] = GNUC_ASM;
-	m["__asm__"] = GNUC_ASM;
-	m["__attribute"] = ATTRIBUTE;
-	m["__attribute__"] = ATTRIBUTE;
-	m["__builtin_choose_expr"] = CHOOSE_EXPR;
-	m["__const"] = TCONST;
-	m["__const__"] = TCONST;
-	m["__inline"] = INLINE;
-	m["__inline__"] = INLINE;
-	m["__label"] = LABEL;
-	m["__label__"] = LABEL;
-	m["__restrict"] = RESTRICT;
-	m["__restrict__"] = RESTRICT;
-	m["__signed"] = SIGNED;
-	m["__signed__"] = SIGNED;
-	m["__typeof"] = TYPEOF;
-	m["__typeof__"] = TYPEOF;
-	m["__alignof"] = ALIGNOF;
-	m["__alignof__"] = ALIGNOF;
-	m["__volatile"] = VOLATILE;
-	m["__volatile__"] = VOLATILE;
-	return m;
-}
-
-// Map from identifiers to keyword token values
-static map<string,int>& keymap = make_keymap();
+// Keywords and their token values
+static KeywordTable keywords(c_keywords);
 
 static int parse_lex_real();
 
@@ -279,7 +223,7 @@ parse_lex_real()
 {
 	int c;
 	Id const *id;
-	map<string,int>::const_iterator ik;
+	int k;
 	extern YYSTYPE parse_lval;
 	extern bool parse_yacc_defs;
 
@@ -324,10 +268,9 @@ again:
 			parse_lval.t = identifier(t);
 			if (parse_yacc_defs)
 				return (IDENTIFIER);
-			ik = keymap.find(t.get_val());
-			if (ik != keymap.end())
+			if ((k = keywords.lookup(t.get_val())) != -1)
 				// Keyword
-				switch ((*ik).second) {
+				switch (k) {
 				case MSC_ASM:
 					Pltoken::set_semicolon_line_comments(true);
 					t = eat_block('{', '}');
@@ -338,7 +281,7 @@ again:
 						return UNUSED;
 					continue;
 				default:
-					return (*ik).second;
+					return k;
 				}
 
 			// Queue identifier for metrics processing
@@ -400,10 +343,7 @@ again:
 int
 Ctoken::lookup_keyword(const string& s)
 {
-	auto ik = keymap.find(s);
-	if (ik == keymap.end())
-		return -1;
-	return ik->second;
+	return keywords.lookup(s);
 }
 
 // Lexical analysis function for yacc
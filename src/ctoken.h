@@ -36,12 +36,7 @@ using namespace std;
 
 char unescape_char(const string& s, string::const_iterator& si);
 
-typedef map<string, int> mapKeyword;
-
 class Ctoken: public Token {
-private:
-	static mapKeyword keywords;
-	static mapKeyword& create_keymap();
 public:
 	Ctoken() {}
 	Ctoken(Pdtoken& t) :
@@ -329,12 +329,9 @@ Dbtoken::write_eclasses(const char *out_path)
 	ofstream of(out_path);
 	verify_open(out_path, of);
 
-	for (auto i = Tokid::begin_ec(); i != Tokid::end_ec(); ++i) {
-		Tokid ti(i->first);
+	Tokid::for_each_ec([&of](Tokid ti, Eclass *ec) {
 		int fid = ti.get_fileid().get_id();
 
-		Eclass *ec = i->second;
-
 		if (fid < 0) {
 			Eclass *ec_twin = twin(ti).check_ec();
 			if (ec_twin) {
@@ -346,7 +343,7 @@ Dbtoken::write_eclasses(const char *out_path)
 						  << "\nRead: " << *ec_twin << " size: " << ec_twin->get_size() << '\n';
 					 csassert(ec_twin->get_len() == ec->get_len());
 				 }
-				continue;
+				return;
 			} else
 				// No twin EC, output the correct fid
 				fid = -fid;
@@ -356,7 +353,7 @@ Dbtoken::write_eclasses(const char *out_path)
 		    << fid << ','
 		    << (unsigned)ti.get_streampos() << ','
 		    << ptr_offset(ec) << '\n';
-	}
+	});
 }
 
 // Read identifiers from in_path and set the EC attributes
@@ -51,6 +51,8 @@
 #include "eclass.h"
 #include "call.h"
 
+int Eclass::count;
+
 // Remove references to the equivalence class from the tokid map
 // Should be called when we delete the ec for good
 void
@@ -69,8 +71,9 @@ merge_into(Eclass *dst, Eclass *src)
 	csassert(src->len == dst->len);
 	if (DP())
 		cout << "merge onto dst=" << dst << *dst << " src=" << src << *src << "\n";
+	dst->members.merge(src->members);
 	for (setTokid::const_iterator i = src->members.begin(); i != src->members.end(); i++)
-		dst->add_tokid(*i);
+		dst->note_member(*i);
 	dst->merge_attributes(src);
 	delete src;
 }
@@ -133,6 +136,12 @@ void
 Eclass::add_tokid(Tokid t)
 {
 	members.insert(t);
+	note_member(t);
+}
+
+void
+Eclass::note_member(Tokid t)
+{
 	t.set_ec(this);
 	if (t.get_readonly()) {
 		if (DP())
@@ -172,14 +181,9 @@ Eclass::functions()
 	set <Call *> r;
 	setTokid::const_iterator i;
 
-	for (i = members.begin(); i != members.end(); i++) {
-		FCallSet fc(Filedetails::get_functions(i->get_fileid()));
-		for (FCallSet::const_iterator j = fc.begin(); j != fc.end(); j++)
-			if ((*j)->is_span_valid() &&
-			    *i >= (*j)->get_begin().get_tokid() &&
-			    *i <= (*j)->get_end().get_tokid())
-				r.insert(*j);
-	}
+	for (i = members.begin(); i != members.end(); i++)
+		Filedetails::get_function_index(i->get_fileid()).for_each_enclosing(*i,
+		    [&r](Call *c) { r.insert(c); });
 	return (r);
 }
 
@@ -32,9 +32,10 @@ using namespace std;
 
 #include "attr.h"
 #include "tokid.h"
+#include "tokidset.h"
 #include "tokmap.h"
 
-typedef set<Tokid> setTokid;
+typedef TokidSet setTokid;
 
 class Call;
 
@@ -43,11 +44,17 @@ private:
 	int len;			// Identifier length
 	setTokid members;		// Class members
 	Attributes attr;
+	static int count;		// Number of live classes
+	// Map t to the class and update the attributes for a new member
+	void note_member(Tokid t);
 public:
 	// An equivalence class shall know its length
 	inline Eclass(int len);
 	// It can be constructed from an initiall Tokid
 	inline Eclass(Tokid t, int len);
+	~Eclass() { count--; }
+	// Return the number of equivalence classes in existence
+	static int get_count() { return count; }
 	// Add t to the class; also updates the Tokmap
 	void add_tokid(Tokid t);
 	// Remove t from the class; also updates the Tokmap
@@ -85,12 +92,14 @@ inline
 Eclass::Eclass(int l)
 : len(l)
 {
+	count++;
 }
 
 inline
 Eclass::Eclass(Tokid t, int l)
 : len(l)
 {
+	count++;
 	add_tokid(t);
 }
 
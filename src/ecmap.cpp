@@ -0,0 +1,110 @@
+/*
+ * (C) Copyright 2026 Diomidis Spinellis
+ *
+ * This file is part of CScout.
+ *
+ * CScout is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * CScout is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with CScout.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *
+ * For documentation read the corresponding .h file
+ *
+ */
+
+#include <algorithm>
+#include <utility>
+#include <vector>
+
+#include "cpp.h"
+#include "ecmap.h"
+
+const unsigned FileEcMap::empty_key;
+
+void
+FileEcMap::grow()
+{
+	vector <unsigned> old_keys;
+	vector <Eclass *> old_values;
+
+	old_keys.swap(keys);
+	old_values.swap(values);
+	bits = bits ? bits + 1 : 4;
+	keys.assign((size_t)1 << bits, empty_key);
+	values.assign((size_t)1 << bits, (Eclass *)NULL);
+	for (size_t i = 0; i < old_keys.size(); i++)
+		if (old_keys[i] != empty_key) {
+			size_t j = probe(old_keys[i]);
+			keys[j] = old_keys[i];
+			values[j] = old_values[i];
+		}
+}
+
+/*
+ * Remove the specified offset.
+ * Linear probing allows us to avoid tombstones by shifting back
+ * the entries that follow in the same cluster.
+ */
+bool
+FileEcMap::erase(cs_offset_t offs)
+{
+	if (count == 0 || !in_range(offs))
+		return false;
+	size_t i = probe((unsigned)offs);
+	if (keys[i] == empty_key)
+		return false;
+
+	size_t mask = keys.size() - 1;
+	for (size_t j = (i + 1) & mask; keys[j] != empty_key; j = (j + 1) & mask) {
+		size_t k = home(keys[j]);
+		// Keep entries whose home lies cyclically in (i, j]
+		if (i <= j ? (i < k && k <= j) : (i < k || k <= j))
+			continue;
+		keys[i] = keys[j];
+		values[i] = values[j];
+		i = j;
+	}
+	keys[i] = empty_key;
+	values[i] = NULL;
+	count--;
+	return true;
+}
+
+void
+FileEcMap::clear()
+{
+	vector <unsigned>().swap(keys);
+	vector <Eclass *>().swap(values);
+	count = 0;
+	bits = 0;
+}
+
+vector <pair <cs_offset_t, Eclass *> >
+FileEcMap::sorted() const
+{
+	vector <pair <cs_offset_t, Eclass *> > r;
+
+	r.reserve(count);
+	for (size_t i = 0; i < keys.size(); i++)
+		if (keys[i] != empty_key)
+			r.push_back(make_pair((cs_offset_t)keys[i], values[i]));
+	sort(r.begin(), r.end());
+	return r;
+}
+
+void
+EcMap::clear()
+{
+	vector <FileEcMap>().swap(pos);
+	vector <FileEcMap>().swap(neg);
+	count = 0;
+}
@@ -0,0 +1,184 @@
+/*
+ * (C) Copyright 2026 Diomidis Spinellis
+ *
+ * This file is part of CScout.
+ *
+ * CScout is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * CScout is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with CScout.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *
+ * The index from token identifiers to their equivalence classes.
+ *
+ * Rationale: a single map<Tokid, Eclass *> costs a tree node per mapped
+ * token, and every lookup walks a tree spanning all workspace files.
+ * Instead, the index is split by Fileid, and each file keeps its
+ * offset to EC mappings in an open-addressing hash table with
+ * linear probing.  Lookups take constant time and only touch the
+ * file's compact key and value arrays.
+ * Ordered traversal, which is only needed for dumps and debugging,
+ * sorts each file's entries on demand.
+ * Offsets are stored as 32-bit keys; larger offsets cannot be mapped.
+ *
+ */
+
+#ifndef ECMAP_
+#define ECMAP_
+
+#include <utility>
+#include <vector>
+
+using namespace std;
+
+#include "cpp.h"
+#include "error.h"
+
+class Eclass;
+
+// The offset to EC mappings of a single file
+class FileEcMap {
+private:
+	vector <unsigned> keys;		// Offsets; empty_key marks free slots
+	vector <Eclass *> values;	// The EC of each occupied slot
+	size_t count;			// Number of occupied slots
+	unsigned bits;			// Table size is 2^bits
+
+	static const unsigned empty_key = ~0u;
+
+	// Return true if offs can be stored as a key
+	static bool in_range(cs_offset_t offs) {
+		return offs >= 0 && (unsigned long long)offs < empty_key;
+	}
+
+	// Return the preferred slot of the specified offset
+	size_t home(unsigned offs) const {
+		return (offs * 2654435769u) >> (32 - bits);
+	}
+	// Return the slot holding offs, or the free slot where it belongs
+	inline size_t probe(unsigned offs) const;
+	// Double the table's size
+	void grow();
+public:
+	FileEcMap() : count(0), bits(0) {}
+	// Return the EC at the specified offset or NULL if none
+	inline Eclass *find(cs_offset_t offs) const;
+	// Associate the specified offset with ec
+	inline void set(cs_offset_t offs, Eclass *ec);
+	// Remove the specified offset; return false if it wasn't there
+	bool erase(cs_offset_t offs);
+	// Remove all entries
+	void clear();
+	size_t size() const { return count; }
+	// Return the file's (offset, EC) pairs ordered by offset
+	vector <pair <cs_offset_t, Eclass *> > sorted() const;
+};
+
+// The offset to EC mappings of all files, indexed by their Fileid value
+class EcMap {
+private:
+	vector <FileEcMap> pos;		// Files with non-negative ids
+	vector <FileEcMap> neg;		// Files with negative ids (see dbtoken.cpp)
+	size_t count;			// Total number of mappings
+public:
+	EcMap() : count(0) {}
+	// Return the mappings of file id, or NULL if it has none
+	const FileEcMap *check_file(int id) const {
+		if (id >= 0)
+			return (unsigned)id < pos.size() ? &pos[id] : NULL;
+		else
+			return (unsigned)-id < neg.size() ? &neg[-id] : NULL;
+	}
+	// Return the mappings of file id, creating them if needed
+	inline FileEcMap &file(int id);
+	inline Eclass *find(int id, cs_offset_t offs) const;
+	inline void set(int id, cs_offset_t offs, Eclass *ec);
+	inline bool erase(int id, cs_offset_t offs);
+	void clear();
+	size_t size() const { return count; }
+	// Smallest and largest file id that may have mappings
+	int min_id() const { return -(int)neg.size() + 1; }
+	int max_id() const { return (int)pos.size() - 1; }
+};
+
+inline size_t
+FileEcMap::probe(unsigned offs) const
+{
+	size_t mask = keys.size() - 1;
+	size_t i;
+
+	for (i = home(offs); keys[i] != empty_key && keys[i] != offs; i = (i + 1) & mask)
+		;
+	return i;
+}
+
+inline Eclass *
+FileEcMap::find(cs_offset_t offs) const
+{
+	if (count == 0 || !in_range(offs))
+		return NULL;
+	size_t i = probe((unsigned)offs);
+	return keys[i] == empty_key ? NULL : values[i];
+}
+
+inline void
+FileEcMap::set(cs_offset_t offs, Eclass *ec)
+{
+	csassert(in_range(offs));
+	// Keep the load factor at most 3/4
+	if ((count + 1) * 4 > keys.size() * 3)
+		grow();
+	size_t i = probe((unsigned)offs);
+	if (keys[i] == empty_key) {
+		keys[i] = (unsigned)offs;
+		count++;
+	}
+	values[i] = ec;
+}
+
+inline FileEcMap &
+EcMap::file(int id)
+{
+	vector <FileEcMap> &v(id >= 0 ? pos : neg);
+	unsigned idx = id >= 0 ? id : -id;
+
+	if (idx >= v.size())
+		v.resize(idx + 1);
+	return v[idx];
+}
+
+inline Eclass *
+EcMap::find(int id, cs_offset_t offs) const
+{
+	const FileEcMap *f = check_file(id);
+	return f ? f->find(offs) : NULL;
+}
+
+inline void
+EcMap::set(int id, cs_offset_t offs, Eclass *ec)
+{
+	FileEcMap &f(file(id));
+	size_t before = f.size();
+
+	f.set(offs, ec);
+	count += f.size() - before;
+}
+
+inline bool
+EcMap::erase(int id, cs_offset_t offs)
+{
+	if (!check_file(id) || !file(id).erase(offs))
+		return false;
+	count--;
+	return true;
+}
+
+#endif /* ECMAP_ */
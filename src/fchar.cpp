@@ -64,13 +64,21 @@ bool Fchar::output_headers;		// Debug print of files being processed
 void
 Fchar::set_input(const string& s)
 {
+	set_input(Fileid(s));
+}
+
+void
+Fchar::set_input(Fileid f)
+{
+	const string &s(f.get_path());
+
 	if (in.is_open())
 		in.close();
 	in.clear();		// Otherwise flags are dirty and open fails
-	in.open(s.c_str(), ios::binary);
+	in.open(f);
 	if (in.fail())
 		Error::error(E_FATAL, s + ": " + string(strerror(errno)), false);
-	fi = Fileid(s);
+	fi = f;
 	Filedetails::set_garbage_collected(fi, false);	// Mark the file for garbage collection
 	if (DP())
 		cout << "set input " << s << " fi: " << fi.get_path() << "\n";
@@ -218,7 +226,7 @@ Fchar::getnext()
 void
 Fchar::set_context(const FcharContext &fc)
 {
-	set_input(fc.get_tokid().get_path());
+	set_input(fc.get_tokid().get_fileid());
 	in.seekg(fc.get_tokid().get_streampos());
 	line_number = fc.get_line_number();
 }
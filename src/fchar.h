@@ -87,6 +87,8 @@ private:
 public:
 	// Will read characters from file named s
 	static void set_input(const string& s);
+	// Will read characters from the file identified by f
+	static void set_input(Fileid f);
 	// From now on will read from s; on EOF resume with previous file
 	// Offset is the location of the include file path where the file
 	// was located, and is used for implementing include_next
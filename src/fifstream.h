@@ -17,25 +17,14 @@
  * along with CScout.  If not, see <http://www.gnu.org/licenses/>.
  *
  *
- * IFstream wrapper for providing a fast tellg()
- * The current (gcc 3.4.2) implementation calls pubseek_off,
- * and then seekoff, which clears the input buffer.
- * Thus, every tellg amounts to an lseek and a read system call.
+ * An input file stream over a file's cached FileView.
+ * It supports the subset of the ifstream methods CScout uses, with
+ * the same end of file and failure semantics, but its get(), tellg(),
+ * putback(), and seekg() methods are inline operations on the file's
+ * (normally memory-mapped) bytes.  Opening a file that was read
+ * before involves no system calls.
  *
  * This file is included by fchar.h; do not include it directly.
- * If a C++ library optimizes the getg() method to avoid the
- * overhead the buffer flush and the lseek, remove the class
- * and add the following:
- * typedef ifstream fifstream;
- *
- * After applying this change, the runtime changes from:
- * real    0m7.782s
- * user    0m5.992s
- * sys     0m1.711s
- * to:
- * real    0m4.524s
- * user    0m4.409s
- * sys     0m0.041s
  *
  */
 
@@ -43,73 +32,76 @@
 #define FIFSTREAM_
 
 #include <fstream>
+#include <memory>
 
 using namespace std;
 
 #include "error.h"
+#include "fileid.h"
+#include "fileview.h"
 
 class fifstream {
 private:
-	bool dirty;		// True if we can't use mypos
-	ifstream i;		// The underlying ifstream
-	long mypos;		// Cached position
+	shared_ptr <const FileView> view;	// The file's contents
+	const char *buf;	// Its bytes
+	size_t len;		// Their number
+	size_t pos;		// Current position
+	bool at_eof;		// True after trying to read past the end
+	bool failed;		// True after a failed operation
 public:
-	fifstream() {}
-	fifstream(const char *s, ios_base::openmode mode = ios_base::out) :
-		dirty(true),
-		i(s, mode)
-	{
-		// If the file is not binary, this optimization will not work
-		csassert(mode & ios::binary);
-	}
+	fifstream() : buf(NULL), len(0), pos(0), at_eof(false), failed(false) {}
 
-	// fifstream supports a subset of the ifstream methods
-	bool is_open() { return i.is_open(); }
-	void close() {
-		i.close();
-		dirty = true;
+	bool is_open() const { return (bool)view; }
+	void open(Fileid fi) {
+		view = FileView::get(fi);
+		pos = 0;
+		if (view->fail()) {
+			failed = true;
+			buf = NULL;
+			len = 0;
+		} else {
+			buf = view->data();
+			len = view->size();
+			at_eof = failed = false;
+		}
 	}
-	void clear(ifstream::iostate state = ifstream::goodbit) {
-		i.clear(state);
-		dirty = true;
+	void close() {
+		view.reset();
+		buf = NULL;
+		len = pos = 0;
 	}
-	void open(const char *s, ios_base::openmode mode = ios_base::out) {
-		// If the file is not binary, this optimization will not work
-		csassert(mode & ios::binary);
-		i.open(s, mode);
-		dirty = true;
+	void clear() {
+		at_eof = failed = false;
 	}
 	bool fail() const {
-		return i.fail();
+		return failed;
 	}
 	bool eof() const {
-		return i.eof();
+		return at_eof;
 	}
-	ifstream::pos_type tellg() {
-		if (dirty) {
-			dirty = false;
-			mypos = (unsigned long)i.tellg();
-		}
-		return (ifstream::pos_type)mypos;
+	ifstream::pos_type tellg() const {
+		return failed ? (ifstream::pos_type)-1 : (ifstream::pos_type)pos;
 	}
 	ifstream::int_type get() {
-		ifstream::int_type r = i.get();
-		if (r == EOF)
-			dirty = true;
-		else
-			mypos++;
-		return r;
+		if (pos < len)
+			return (unsigned char)buf[pos++];
+		at_eof = failed = true;
+		return EOF;
 	}
 	fifstream &putback(char c) {
-		i.putback(c);
-		mypos--;
+		if (!failed && pos > 0)
+			pos--;
 		return *this;
 	}
-	fifstream &seekg(ifstream::pos_type pos) {
-		i.seekg(pos);
-		dirty = true;
+	fifstream &seekg(ifstream::pos_type p) {
+		at_eof = false;
+		if (!failed)
+			pos = (size_t)(streamoff)p;
 		return *this;
 	}
+	// Return the file's bytes and their number
+	const char *data() const { return buf; }
+	size_t size() const { return len; }
 };
 
 #endif /* FIFSTREAM_ */
@@ -33,6 +33,9 @@
 #include <cctype>
 #include <vector>
 #include <algorithm>
+#include <cstring>		// strerror
+#include <memory>
+#include <errno.h>
 #if defined(unix) || defined(__unix__) || defined(__MACH__)
 #include <unistd.h>		// access(2)
 #else
@@ -54,16 +57,20 @@
 #include "ptoken.h"
 #include "pltoken.h"
 #include "call.h"
-#include "md5.h"
+#include "eclass.h"
+#include "fdep.h"
+#include "parallel.h"
 #include "os.h"
+#include "fileview.h"
+#include "contenthash.h"
 
 
-Filedetails::Filedetails(string n, bool r, const FileHash &h) :
+Filedetails::Filedetails(string n, bool r) :
 	name(n),
 	garbage_collected(false),
 	required(false),
 	compilation_unit(false),
-	hash(h),
+	contents_key(no_contents, FileHash()),
 	ipath_offset(0),
 	hand_edited(false),
 	visited(false)
@@ -170,6 +177,23 @@ Filedetails::set_hand_edited()
 	return 0;
 }
 
+const FunctionIndex &
+Filedetails::get_function_index(Fileid id)
+{
+	Filedetails &d(get_instance(id));
+	if (!d.fun_index.is_valid())
+		d.fun_index.build(d.df);
+	return d.fun_index;
+}
+
+void
+Filedetails::index_functions()
+{
+	for (FI_id_to_details::iterator i = i2d.begin(); i != i2d.end(); i++)
+		if (!i->fun_index.is_valid())
+			i->fun_index.build(i->df);
+}
+
 void
 Filedetails::clear_all_visited()
 {
@@ -177,57 +201,175 @@ Filedetails::clear_all_visited()
 		i->clear_visited();
 }
 
-// Read identifier tokens from file fname into tkov
+// A span of offsets of identical files that must map to common ECs
+typedef pair <cs_offset_t, cs_offset_t> OffsetSpan;
+
+/*
+ * Lex file fi, creating ECs for its identifiers that no processing
+ * has reached, such as those in #if 0 blocks.
+ * The lexer's input is shared, so this cannot run concurrently.
+ */
 static void
-read_file(const string &fname, vector <Pltoken> &tokv)
+create_identifier_ecs(Fileid fi)
 {
-	Fchar::set_input(fname);
+	Fchar::set_input(fi);
 	Pltoken t;
 
-	for (;;) {
+	do
 		t.getnext<Fchar>();
-		switch (t.get_code()) {
-		case IDENTIFIER:
-			tokv.push_back(t);
-			break;
-		case EOF:
-			return;
+	while (t.get_code() != EOF);
+}
+
+/*
+ * Return the spans into which the ECs of the files in fs divide them.
+ * The files are identical, so the same offsets in each of them
+ * refer to the same characters.  Every start or end of an EC in
+ * any file begins a new span.
+ * This only reads the tokid map, and can therefore run concurrently.
+ */
+static vector <OffsetSpan>
+identical_file_spans(const set<Fileid> &fs)
+{
+	vector <pair <cs_offset_t, int> > bounds;	// Offset, coverage change
+
+	for (set <Fileid>::const_iterator fi = fs.begin(); fi != fs.end(); fi++)
+		for (auto &e : Tokid::file_ecs(*fi)) {
+			bounds.push_back(make_pair(e.first, 1));
+			bounds.push_back(make_pair(e.first + e.second->get_len(), -1));
 		}
+	sort(bounds.begin(), bounds.end());
+
+	vector <OffsetSpan> r;
+	int coverage = 0;		// Number of ECs covering the current offset
+	for (size_t i = 0; i < bounds.size(); ) {
+		cs_offset_t offs = bounds[i].first;
+		if (coverage > 0)
+			r.back().second = offs;		// Close the span ending here
+		for (; i < bounds.size() && bounds[i].first == offs; i++)
+			coverage += bounds[i].second;
+		if (coverage > 0)
+			r.push_back(OffsetSpan(offs, offs));	// Open a new one
 	}
+	return r;
 }
 
 /*
  * Unify all identifiers in the files of fs
- * The corresponding files should be exact duplicates
+ * The corresponding files should be exact duplicates, divided by
+ * the ECs of all of them into the specified spans.
+ * In each span all files get an EC of the same length, by splitting
+ * existing ECs or creating new ones; these ECs are then merged.
  */
 static void
-unify_file_identifiers(const set<Fileid> &fs)
+unify_file_identifiers(const set<Fileid> &fs, const vector <OffsetSpan> &spans)
 {
 	csassert(fs.size() > 1);
-	Fileid fi = *(fs.begin());
-	fifstream in;
-	vector <Pltoken> ft0, ftn;	// The tokens to unify
-
-	read_file(fi.get_path(), ft0);
-
-	set <Fileid>::const_iterator fsi = fs.begin();
-	for (fsi++; fsi != fs.end(); fsi++) {
-		if (DP())
-			// endl ensures flushing
-			cout << "Merging identifiers of " << fi.get_path() << " and " << fsi->get_path() << endl;
-		read_file(fsi->get_path(), ftn);
-		csassert(ft0.size() == ftn.size());
-		vector <Pltoken>::iterator ti0, tin;
-		for (ti0 = ft0.begin(), tin = ftn.begin(); ti0 != ft0.end(); ti0++, tin++)
-			Token::unify(*ti0, *tin);
-		ftn.clear();
+	Fileid f0 = *(fs.begin());
+
+	if (DP())
+		// endl ensures flushing
+		cout << "Merging identifiers of " << fs.size() << " copies of " << f0.get_path() << endl;
+	for (vector <OffsetSpan>::const_iterator si = spans.begin(); si != spans.end(); si++)
+		for (cs_offset_t pos = si->first; pos < si->second; ) {
+			/*
+			 * Common length of the ECs starting here; shorter than
+			 * the span if merging earlier groups has split some
+			 */
+			int len = si->second - pos;
+			for (set <Fileid>::const_iterator fi = fs.begin(); fi != fs.end(); fi++) {
+				Eclass *ec = Tokid(*fi, pos).check_ec();
+				if (ec && ec->get_len() < len)
+					len = ec->get_len();
+			}
+			Eclass *merged = NULL;
+			for (set <Fileid>::const_iterator fi = fs.begin(); fi != fs.end(); fi++) {
+				Tokid t(*fi, pos);
+				Eclass *ec = t.check_ec();
+				if (ec == NULL)
+					ec = new Eclass(t, len);
+				else if (ec->get_len() > len)
+					ec->split(len);
+				merged = merged ? merge(merged, ec) : ec;
+				if (*fi != f0)
+					Fdep::add_def_ref(Tokid(f0, pos), t, len);
+			}
+			pos += len;
+		}
+}
+
+const size_t Filedetails::no_contents;
+
+// Return the hash of the specified file's contents
+static FileHash
+contents_hash(Fileid fi)
+{
+	shared_ptr <const FileView> v(FileView::get(fi));
+	if (v->fail())
+		Error::error(E_FATAL, fi.get_path() + ": " + string(strerror(errno)), false);
+	return ContentHash::compute(v->data(), v->size());
+}
+
+void
+Filedetails::hash_contents(FI_hash_to_ids::iterator i)
+{
+	Fileid fi(*i->second.begin());
+	Filedetails &d(get_instance(fi));
+
+	identical_files.erase(i);
+	d.contents_key.second = contents_hash(fi);
+	identical_files[d.contents_key].insert(fi);
+}
+
+void
+Filedetails::add_identical_file(Fileid fi, size_t size)
+{
+	Filedetails &d(get_instance(fi));
+
+	d.contents_key = FI_contents_key(size, FileHash());
+	if (size != no_contents) {
+		FI_hash_to_ids::iterator i = identical_files.lower_bound(d.contents_key);
+		if (i != identical_files.end() && i->first.first == size) {
+			// Files of the same size exist; compare their hashes
+			if (i->first.second.empty())
+				hash_contents(i);
+			d.contents_key.second = contents_hash(fi);
+		}
 	}
+	identical_files[d.contents_key].insert(fi);
 }
 
+const FileHash &
+Filedetails::get_content_hash(Fileid fi)
+{
+	Filedetails &d(get_instance(fi));
+
+	if (d.contents_key.second.empty() && d.contents_key.first != no_contents)
+		hash_contents(identical_files.find(d.contents_key));
+	return d.contents_key.second;
+}
+
+/*
+ * The first file of each group is lexed, so that its unprocessed
+ * identifiers also get ECs, which then extend to the other files.
+ * The spans of each group of identical files are found in parallel.
+ * ECs are however shared between groups, so they are merged serially.
+ */
 void
 Filedetails::unify_identical_files(void)
 {
+	vector <const set<Fileid> *> groups;
 	for (FI_hash_to_ids::const_iterator i = identical_files.begin(); i != identical_files.end(); i++)
 		if (i->second.size() > 1)
-			unify_file_identifiers(i->second);
+			groups.push_back(&i->second);
+
+	for (size_t i = 0; i < groups.size(); i++)
+		create_identifier_ecs(*groups[i]->begin());
+	vector <vector <OffsetSpan> > spans(groups.size());
+	Parallel::for_each_index(groups.size(), [&](size_t i) {
+		spans[i] = identical_file_spans(*groups[i]);
+	});
+	for (size_t i = 0; i < groups.size(); i++) {
+		unify_file_identifiers(*groups[i], spans[i]);
+		vector <OffsetSpan>().swap(spans[i]);
+	}
 }
@@ -36,6 +36,7 @@ using namespace std;
 #include "filemetrics.h"
 #include "token.h"
 #include "ctoken.h"
+#include "funindex.h"
 
 class Pltoken;
 
@@ -44,8 +45,11 @@ class Pltoken;
  * The value type must be ordered by the integer Fileid
  * in order to keep *values.begin() invariant.
  * This property is used by tokid unique for returning unique tokids
+ * Files are keyed by their size and their contents' hash, which is
+ * only calculated when another file has the same size.
  */
-typedef map <FileHash, set<Fileid> > FI_hash_to_ids;
+typedef pair <size_t, FileHash> FI_contents_key;
+typedef map <FI_contents_key, set<Fileid> > FI_hash_to_ids;
 
 // Details we keep for each included file for a given includer
 class IncDetails {
@@ -99,7 +103,7 @@ private:
 	vector <bool> processed_lines;;
 	FileIncMap includes;	// Files we include
 	FileIncMap includers;	// Files that include us
-	FileHash hash;			// MD5 hash for the file's contents
+	FI_contents_key contents_key;	// Size and (when needed) hash of the contents
 	int ipath_offset;	// Offset in the include file path where this file was found
 	Fileidset runtime_uses;	// Files whose global objects this file uses at runtime
 	Fileidset runtime_used_by;	// Files that use at runtime this file's global objects
@@ -110,16 +114,19 @@ private:
 	bool hand_edited;	// True for files that have been hand-edited
 	string contents;	// Original contents, if hand-edited
 	bool visited;                   // For calculating transitive closures
+	FunctionIndex fun_index;	// Index of the spans of df
 
 	static FI_id_to_details i2d;	// From id to file details
 	static FI_hash_to_ids identical_files;// Files that are exact duplicates
+	// Hash the contents of the single unhashed file of identical_files i
+	static void hash_contents(FI_hash_to_ids::iterator i);
 public:
 	Attributes attr;		// The projects this file participates in
 	FileMetrics pre_cpp_metrics;	// File's metrics before cpp
 	FileMetrics post_cpp_metrics;	// File's metrics after cpp
 
 	FCallSet df;			// Functions defined in this file
-	Filedetails(string n, bool r, const FileHash &h);
+	Filedetails(string n, bool r);
 	Filedetails();
 
 	// Return the instance associated with the specified id
@@ -138,8 +145,8 @@ public:
 	}
 
 	// Add a new instance with the specified ctor values
-	static void add_instance(string n, bool r, const FileHash &h) {
-		i2d.emplace_back(n, r, h);
+	static void add_instance(string n, bool r) {
+		i2d.emplace_back(n, r);
 	}
 
 	// Unify identifiers of files that are exact copies
@@ -148,14 +155,15 @@ public:
 	// Clear the visited flag for all fileids
 	static void clear_all_visited();
 
-	// Add fi to the set of files that have the identical hash
-	static void add_identical_file(FileHash hash, Fileid fi) {
-		identical_files[hash].insert(fi);
-	}
+	// The size of files whose contents are not available
+	static const size_t no_contents = (size_t)-1;
+	// Add fi, whose contents are size bytes long, to the identical files
+	static void add_identical_file(Fileid fi, size_t size);
+	// Return the hash of fi's contents, calculating it if needed
+	static const FileHash &get_content_hash(Fileid fi);
 
 	const string& get_name() const { return name; }
 	bool get_readonly() { return attr.get_attribute(is_readonly); }
-	const FileHash & get_filehash() const { return hash; }
 	void set_readonly(bool r) { attr.set_attribute_val(is_readonly, r); }
 	bool is_garbage_collected() const { return garbage_collected; }
 	void set_garbage_collected(bool r) { garbage_collected = r; }
@@ -232,8 +240,14 @@ public:
 
 	static void add_function(Fileid id, Call *f) {
 		get_instance(id).df.insert(f);
+		get_instance(id).fun_index.invalidate();
 	}
 
+	// Return an index of the file's function definition spans
+	static const FunctionIndex &get_function_index(Fileid id);
+	// Build the function span indexes of all files
+	static void index_functions();
+
 	// Get /set attributes
 	static void set_attribute(Fileid id, int v) {
 		get_instance(id).attr.set_attribute(v);
@@ -281,8 +295,10 @@ public:
 	}
 ;
 	// Return the set of files that are the same as this (including this)
+	// Files are registered on creation, so this is safe to call
+	// concurrently from post-processing threads.
 	static const Fileidset & get_identical_files(Fileid id) {
-		return identical_files[get_instance(id).get_filehash()];
+		return identical_files.find(get_instance(id).contents_key)->second;
 	}
 
 	// Return the set of files that we depend on for runtime objects
@@ -33,6 +33,10 @@
 #include <cctype>
 #include <vector>
 #include <algorithm>
+#include <memory>
+#include <unordered_map>
+#include <cstring>		// strerror
+#include <errno.h>
 #if defined(unix) || defined(__unix__) || defined(__MACH__)
 #include <unistd.h>		// access(2)
 #else
@@ -54,8 +58,8 @@
 #include "ptoken.h"
 #include "pltoken.h"
 #include "call.h"
-#include "md5.h"
 #include "os.h"
+#include "fileview.h"
 
 int Fileid::counter;		// To generate ids
 bool Fileid::filedetails_disabled;	// Disables filedetails access
@@ -102,6 +106,16 @@ Fileid::is_readonly(string fname)
 
 Fileid::Fileid(const string &name)
 {
+	// A path spelling seen before needs no system calls
+	string qname(is_absolute_filename(name) ? name : get_current_dir() + "/" + name);
+	FI_path_to_id::const_iterator pi;
+	if ((pi = p2i.find(qname)) != p2i.end()) {
+		id = pi->second;
+		if (DP())
+			cout << "Fileid(" << name << ") = " << id << " (cached)\n";
+		return;
+	}
+
 	// String identifier of the file
 	string sid(get_uniq_fname_string(name.c_str()));
 	FI_uname_to_id::const_iterator uni;
@@ -112,14 +126,17 @@ Fileid::Fileid(const string &name)
 	} else {
 		// New filename; add a new fname/id pair in the map tables
 		string fpath(get_full_path(name.c_str()));
-		unsigned char *h = MD5File(name.c_str());
-		FileHash hash(h, h + 16);
 
 		u2i[sid] = id = counter++;
-		Filedetails::add_instance(fpath, is_readonly(name.c_str()), hash);
+		Filedetails::add_instance(fpath, is_readonly(name.c_str()));
 
-		Filedetails::add_identical_file(hash, *this);
+		// The view is cached and is also used for lexing the file
+		shared_ptr <const FileView> v(FileView::get(*this));
+		if (v->fail())
+			Error::error(E_FATAL, name + ": " + string(strerror(errno)), false);
+		Filedetails::add_identical_file(*this, v->size());
 	}
+	p2i[qname] = id;
 	if (DP())
 		cout << "Fileid(" << name << ") = " << id << "\n";
 }
@@ -128,9 +145,9 @@ Fileid::Fileid(const string &name)
 Fileid::Fileid(const string &name, int i)
 {
 	u2i[name] = i;
-	Filedetails::add_instance(name, true, FileHash());
+	Filedetails::add_instance(name, true);
 	id = i;
-	Filedetails::add_identical_file(FileHash(), *this);
+	Filedetails::add_identical_file(*this, Filedetails::no_contents);
 	counter = i + 1;
 }
 
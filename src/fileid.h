@@ -30,6 +30,7 @@
 #include <map>
 #include <set>
 #include <string>
+#include <unordered_map>
 #include <vector>
 
 using namespace std;
@@ -39,6 +40,7 @@ class FileMetrics;
 
 typedef vector<unsigned char> FileHash;
 typedef map <string, int> FI_uname_to_id;
+typedef unordered_map <string, int> FI_path_to_id;
 
 /*
  * A unique file identifier
@@ -52,6 +54,7 @@ private:
 
 	static int counter;		// To generate ids
 	static FI_uname_to_id u2i;	// From unique name to id
+	static FI_path_to_id p2i;	// From path spellings seen to id
 
 	// Construct a new Fileid given a name and id value
 	// Only used internally for creating the anonymous id
@@ -118,6 +118,8 @@ public:
 	double get_post_cpp_writable(int i) {
 		return rw[0].get_post_cpp_total(i);
 	}
+	const MetricsRange<FileMetrics, Fileid> &get_writable() const { return rw[0]; }
+	const MetricsRange<FileMetrics, Fileid> &get_readonly() const { return rw[1]; }
 };
 
 extern FileMetricsSummary file_msum;
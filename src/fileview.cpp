@@ -0,0 +1,137 @@
+/*
+ * (C) Copyright 2026 Diomidis Spinellis
+ *
+ * This file is part of CScout.
+ *
+ * CScout is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * CScout is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with CScout.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *
+ * For documentation read the corresponding .h file
+ *
+ */
+
+#include <fstream>
+#include <iterator>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+#include <errno.h>
+
+#if defined(unix) || defined(__unix__) || defined(__MACH__)
+#include <sys/types.h>
+#include <sys/stat.h>
+#include <sys/mman.h>
+#include <fcntl.h>
+#include <unistd.h>
+#define HAVE_MMAP
+#endif
+
+#include "fileid.h"
+#include "fileview.h"
+
+vector <shared_ptr <const FileView> > FileView::cache;
+mutex FileView::cache_mutex;
+
+FileView::FileView(const string &path) :
+	buf(NULL),
+	len(0),
+	mapped(false),
+	error(0)
+{
+#ifdef HAVE_MMAP
+	int fd = open(path.c_str(), O_RDONLY);
+	if (fd < 0) {
+		error = errno;
+		return;
+	}
+	struct stat sb;
+	if (fstat(fd, &sb) == 0 && S_ISREG(sb.st_mode)) {
+		if (sb.st_size == 0) {
+			close(fd);
+			return;
+		}
+		void *p = mmap(NULL, sb.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+		if (p != MAP_FAILED) {
+			buf = (const char *)p;
+			len = sb.st_size;
+			mapped = true;
+			close(fd);
+			return;
+		}
+	}
+	// Not a regular file, or mmap failed; read it instead
+	close(fd);
+#endif
+	ifstream in(path.c_str(), ios::binary);
+	if (in.fail()) {
+		error = errno ? errno : EIO;
+		return;
+	}
+	contents.assign(istreambuf_iterator<char>(in), istreambuf_iterator<char>());
+	buf = contents.data();
+	len = contents.size();
+}
+
+FileView::~FileView()
+{
+#ifdef HAVE_MMAP
+	if (mapped)
+		(void)munmap((void *)buf, len);
+#endif
+}
+
+shared_ptr <const FileView>
+FileView::get(Fileid fi)
+{
+	int id = fi.get_id();
+
+	{
+		lock_guard <mutex> lock(cache_mutex);
+		if (id >= 0 && (unsigned)id < cache.size() && cache[id])
+			return cache[id];
+	}
+	// Map the file without holding the lock
+	shared_ptr <const FileView> v(new FileView(fi.get_path()));
+	if (v->fail()) {
+		errno = v->get_error();
+		return v;
+	}
+	lock_guard <mutex> lock(cache_mutex);
+	if (id >= 0) {
+		if ((unsigned)id < cache.size() && cache[id])
+			return cache[id];	// Another thread got there first
+		if ((unsigned)id >= cache.size())
+			cache.resize(id + 1);
+		cache[id] = v;
+	}
+	return v;
+}
+
+void
+FileView::invalidate(Fileid fi)
+{
+	int id = fi.get_id();
+
+	lock_guard <mutex> lock(cache_mutex);
+	if (id >= 0 && (unsigned)id < cache.size())
+		cache[id].reset();
+}
+
+void
+FileView::clear()
+{
+	lock_guard <mutex> lock(cache_mutex);
+	cache.clear();
+}
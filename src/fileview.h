@@ -0,0 +1,76 @@
+/*
+ * (C) Copyright 2026 Diomidis Spinellis
+ *
+ * This file is part of CScout.
+ *
+ * CScout is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * CScout is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with CScout.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *
+ * A read-only view of a source file's bytes.
+ * Where available the file is memory-mapped; otherwise its contents
+ * are read into memory.  Views are cached by Fileid, so that the lexing
+ * pass and all subsequent rescans of a file share the same bytes.
+ * The cache can be accessed concurrently by post-processing threads.
+ *
+ */
+
+#ifndef FILEVIEW_
+#define FILEVIEW_
+
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+using namespace std;
+
+#include "fileid.h"
+
+class FileView {
+private:
+	const char *buf;		// The file's bytes
+	size_t len;			// Their number
+	bool mapped;			// True if buf is memory-mapped
+	int error;			// The errno value of a failed open
+	string contents;		// Storage when not memory-mapped
+
+	// Cached views, indexed by Fileid
+	static vector <shared_ptr <const FileView> > cache;
+	static mutex cache_mutex;		// Protects cache
+
+	FileView(const FileView &);
+	FileView &operator=(const FileView &);
+public:
+	// Map or read the specified file
+	FileView(const string &path);
+	~FileView();
+	// Return true if the file could not be accessed; errno is in get_error
+	bool fail() const { return error != 0; }
+	int get_error() const { return error; }
+	const char *data() const { return buf; }
+	size_t size() const { return len; }
+
+	/*
+	 * Return a shared view of the specified file.
+	 * On failure the returned view's fail() method returns true,
+	 * and errno is set accordingly.
+	 */
+	static shared_ptr <const FileView> get(Fileid fi);
+	// Forget a file's cached view; call when the file gets modified
+	static void invalidate(Fileid fi);
+	// Forget all cached views
+	static void clear();
+};
+
+#endif /* FILEVIEW_ */
@@ -0,0 +1,58 @@
+/*
+ * (C) Copyright 2026 Diomidis Spinellis
+ *
+ * This file is part of CScout.
+ *
+ * CScout is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * CScout is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with CScout.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *
+ * For documentation read the corresponding .h file
+ *
+ */
+
+#include <algorithm>
+#include <set>
+#include <vector>
+
+#include "cpp.h"
+#include "fileid.h"
+#include "tokid.h"
+#include "call.h"
+#include "filedetails.h"
+#include "funindex.h"
+
+void
+FunctionIndex::build(const FCallSet &functions)
+{
+	spans.clear();
+	for (FCallSet::const_iterator i = functions.begin(); i != functions.end(); i++)
+		if ((*i)->is_span_valid())
+			spans.push_back(Span((*i)->get_begin().get_tokid(),
+			    (*i)->get_end().get_tokid(), *i));
+	sort(spans.begin(), spans.end());
+
+	/*
+	 * A span's parent is the innermost preceding span that has not
+	 * ended before it begins.  The chain of parents therefore contains
+	 * all the preceding spans that can enclose a token after its beginning.
+	 */
+	vector <int> open;
+	for (int i = 0; i < (int)spans.size(); i++) {
+		while (!open.empty() && spans[open.back()].end < spans[i].begin)
+			open.pop_back();
+		spans[i].parent = open.empty() ? -1 : open.back();
+		open.push_back(i);
+	}
+	valid = true;
+}
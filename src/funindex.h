@@ -0,0 +1,85 @@
+/*
+ * (C) Copyright 2026 Diomidis Spinellis
+ *
+ * This file is part of CScout.
+ *
+ * CScout is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * CScout is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with CScout.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *
+ *
+ * An index from a file's tokens to the functions whose definitions
+ * span them.  Definitions can nest (for example, a function-like
+ * macro defined within a function's body), so each function
+ * also points to the closest preceding function that may still
+ * enclose it.  Looking up the functions enclosing a token then takes
+ * a binary search followed by a walk up the enclosing chain.
+ *
+ */
+
+#ifndef FUNINDEX_
+#define FUNINDEX_
+
+#include <set>
+#include <vector>
+
+using namespace std;
+
+#include "tokid.h"
+
+class Call;
+struct function_file_order;
+
+class FunctionIndex {
+private:
+	struct Span {
+		Tokid begin, end;	// The function's definition span
+		Call *fun;		// The function
+		int parent;		// Index of a possibly enclosing span or -1
+		Span(Tokid b, Tokid e, Call *f) : begin(b), end(e), fun(f), parent(-1) {}
+		// Order by beginning; outer spans before the inner ones
+		bool operator <(const Span &s) const {
+			return begin < s.begin || (begin == s.begin && s.end < end);
+		}
+	};
+	vector <Span> spans;		// Ordered spans
+	bool valid;			// True if spans reflect the file's functions
+public:
+	FunctionIndex() : valid(false) {}
+	bool is_valid() const { return valid; }
+	void invalidate() { valid = false; spans.clear(); }
+	// Build the index from the specified functions
+	void build(const set <Call *, function_file_order> &functions);
+	// Call f(c) for every function c whose definition spans t
+	template <typename F> void for_each_enclosing(Tokid t, F f) const;
+};
+
+template <typename F>
+void
+FunctionIndex::for_each_enclosing(Tokid t, F f) const
+{
+	// Find the last span beginning at or before t
+	int lo = 0, hi = spans.size();
+	while (lo < hi) {
+		int mid = (lo + hi) / 2;
+		if (spans[mid].begin <= t)
+			lo = mid + 1;
+		else
+			hi = mid;
+	}
+	for (int i = lo - 1; i >= 0; i = spans[i].parent)
+		if (t <= spans[i].end)
+			f(spans[i].fun);
+}
+
+#endif /* FUNINDEX_ */
@@ -100,6 +100,7 @@ public:
 	// Create function summary
 	void summarize_functions();
 	friend ostream& operator<<(ostream& o,const FunMetricsSummary &ms);
+	const MetricsRange<FunMetrics, Call> &get_range() const { return val; }
 };
 
 extern FunMetricsSummary fun_msum;
@@ -233,11 +233,10 @@ FunQuery::eval(Call *c)
 	if (id_ec) {
 		if (!c->is_span_valid())
 			return false;
+		// The members are ordered; check the first one after the begin
 		const setTokid &m = id_ec->get_members();
-		for (setTokid::const_iterator i = m.begin(); i != m.end(); i++)
-			if (*i >= c->get_begin().get_tokid() && *i <= c->get_end().get_tokid())
-			    	return true;
-		return false;
+		setTokid::const_iterator i = lower_bound(m.begin(), m.end(), c->get_begin().get_tokid());
+		return i != m.end() && *i <= c->get_end().get_tokid();
 	}
 
 	if (match_fid && c->get_begin().get_tokid().get_fileid() != fid)
@@ -0,0 +1,220 @@
+/*
+ * (C) Copyright 2026 Diomidis Spinellis
+ *
+ * This file is part of CScout.
+ *
+ * CScout is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * CScout is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with CScout.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *
+ * For documentation read the corresponding .h file
+ *
+ */
+
+#include <algorithm>
+#include <iterator>
+#include <map>
+#include <unordered_map>
+#include <vector>
+
+#include "cpp.h"
+#include "token.h"
+#include "hideset.h"
+
+map <Token, HideSet::atom_type> HideSet::atom_index;
+vector <Token> HideSet::tokens;
+// The empty set is always present as set 0
+vector <HideSet::members_type> HideSet::sets(1);
+map <HideSet::members_type, HideSet::id_type> HideSet::set_index;
+HideSet::memo_type HideSet::insert_memo;
+HideSet::memo_type HideSet::union_memo;
+HideSet::memo_type HideSet::intersection_memo;
+
+HideSet::atom_type
+HideSet::atom(const Token &t)
+{
+	map <Token, atom_type>::const_iterator i = atom_index.find(t);
+	if (i != atom_index.end())
+		return i->second;
+	atom_type a = tokens.size();
+	tokens.push_back(t);
+	atom_index.insert(make_pair(t, a));
+	return a;
+}
+
+HideSet
+HideSet::intern(const members_type &m)
+{
+	if (m.empty())
+		return HideSet();
+	map <members_type, id_type>::const_iterator i = set_index.find(m);
+	if (i != set_index.end())
+		return HideSet(i->second);
+	id_type n = sets.size();
+	sets.push_back(m);
+	set_index.insert(make_pair(m, n));
+	return HideSet(n);
+}
+
+bool
+HideSet::contains(atom_type a) const
+{
+	const members_type &m(sets[id]);
+	return binary_search(m.begin(), m.end(), a);
+}
+
+void
+HideSet::clear()
+{
+	sets.resize(1);
+	set_index.clear();
+	insert_memo.clear();
+	union_memo.clear();
+	intersection_memo.clear();
+}
+
+HideSet
+HideSet::insert(atom_type a) const
+{
+	memo_type::const_iterator i = insert_memo.find(key(id, a));
+	if (i != insert_memo.end())
+		return HideSet(i->second);
+	HideSet r(*this);
+	if (!contains(a)) {
+		members_type m(sets[id]);
+		m.insert(lower_bound(m.begin(), m.end(), a), a);
+		r = intern(m);
+	}
+	insert_memo[key(id, a)] = r.id;
+	return r;
+}
+
+HideSet
+HideSet::unite(HideSet s) const
+{
+	if (s.id == 0 || s.id == id)
+		return *this;
+	if (id == 0)
+		return s;
+	// The operation is commutative
+	unsigned long long k = id < s.id ? key(id, s.id) : key(s.id, id);
+	memo_type::const_iterator i = union_memo.find(k);
+	if (i != union_memo.end())
+		return HideSet(i->second);
+	members_type m;
+	set_union(sets[id].begin(), sets[id].end(),
+	    sets[s.id].begin(), sets[s.id].end(), back_inserter(m));
+	HideSet r(intern(m));
+	union_memo[k] = r.id;
+	return r;
+}
+
+HideSet
+HideSet::intersect(HideSet s) const
+{
+	if (s.id == id || id == 0)
+		return *this;
+	if (s.id == 0)
+		return s;
+	unsigned long long k = id < s.id ? key(id, s.id) : key(s.id, id);
+	memo_type::const_iterator i = intersection_memo.find(k);
+	if (i != intersection_memo.end())
+		return HideSet(i->second);
+	members_type m;
+	set_intersection(sets[id].begin(), sets[id].end(),
+	    sets[s.id].begin(), sets[s.id].end(), back_inserter(m));
+	HideSet r(intern(m));
+	intersection_memo[k] = r.id;
+	return r;
+}
+
+#ifdef TEST
+/*
+ * Compare random operations on hide sets against std::set.
+ * c++ -DTEST hideset.cpp -o hideset-test && ./hideset-test [seed]
+ */
+#include <cstdlib>
+#include <iostream>
+#include <set>
+
+typedef set <HideSet::atom_type> Reference;
+
+// Verify that h has the members of r; return true if so
+static bool
+check(HideSet h, const Reference &r)
+{
+	const HideSet::members_type &m(h.members());
+	if (m.size() != r.size() || !equal(m.begin(), m.end(), r.begin()) ||
+	    h.empty() != r.empty())
+		return false;
+	for (HideSet::atom_type a = 0; a < 40; a++)
+		if (h.contains(a) != (r.count(a) != 0))
+			return false;
+	return true;
+}
+
+int
+main(int argc, char *argv[])
+{
+	srand(argc > 1 ? atoi(argv[1]) : 1);
+	for (int unit = 0; unit < 10; unit++) {
+		vector <HideSet> h(1);
+		vector <Reference> r(1);
+		for (int i = 0; i < 10000; i++) {
+			size_t a = rand() % h.size(), b = rand() % h.size();
+			HideSet hs;
+			Reference rs;
+			switch (rand() % 3) {
+			case 0: {
+				HideSet::atom_type atom = rand() % 40;
+				hs = h[a].insert(atom);
+				rs = r[a];
+				rs.insert(atom);
+				break;
+			}
+			case 1:
+				hs = h[a].unite(h[b]);
+				rs = r[a];
+				rs.insert(r[b].begin(), r[b].end());
+				break;
+			case 2:
+				hs = h[a].intersect(h[b]);
+				set_intersection(r[a].begin(), r[a].end(),
+				    r[b].begin(), r[b].end(),
+				    inserter(rs, rs.begin()));
+				break;
+			}
+			if (!check(hs, rs)) {
+				cout << "Mismatch in unit " << unit << " operation " << i << endl;
+				return 1;
+			}
+			// Interning: equal sets must be represented identically
+			for (size_t j = 0; j < h.size(); j++)
+				if ((h[j] == hs) != (r[j] == rs)) {
+					cout << "Interning error in unit " << unit << " operation " << i << endl;
+					return 1;
+				}
+			if (h.size() < 200) {
+				h.push_back(hs);
+				r.push_back(rs);
+			} else {
+				h[a] = hs;
+				r[a] = rs;
+			}
+		}
+		HideSet::clear();
+	}
+	cout << "OK" << endl;
+	return 0;
+}
+#endif /* TEST */
@@ -0,0 +1,91 @@
+/*
+ * (C) Copyright 2026 Diomidis Spinellis
+ *
+ * This file is part of CScout.
+ *
+ * CScout is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * CScout is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with CScout.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *
+ *
+ * Interned macro expansion hide sets.
+ * The hide set of a preprocessor token contains the names of the
+ * macros whose expansion produced it.  Every distinct hide set is
+ * stored only once, and tokens refer to it through a small integer.
+ * The results of inserting, uniting, and intersecting sets are
+ * memoized, so macro expansion does not allocate memory for each
+ * token it produces.
+ * The sets and memoized results are discarded after each compilation
+ * unit; atoms live as long as the macros that refer to them.
+ *
+ */
+
+#ifndef HIDESET_
+#define HIDESET_
+
+#include <map>
+#include <unordered_map>
+#include <vector>
+
+using namespace std;
+
+#include "token.h"
+
+class HideSet {
+public:
+	typedef unsigned atom_type;	// A token that can be a set member
+	typedef vector <atom_type> members_type;
+private:
+	typedef unsigned id_type;	// A set; 0 is the empty one
+	typedef unordered_map <unsigned long long, id_type> memo_type;
+
+	id_type id;
+
+	static map <Token, atom_type> atom_index;	// Atoms of tokens
+	static vector <Token> tokens;		// Tokens of atoms
+	static vector <members_type> sets;	// Sorted members of each set
+	static map <members_type, id_type> set_index;	// Sets of members
+	// Memoized results of operations on sets and atoms
+	static memo_type insert_memo, union_memo, intersection_memo;
+
+	HideSet(id_type i) : id(i) {}
+	// Return the key for memoizing an operation on a and b
+	static unsigned long long key(unsigned a, unsigned b) {
+		return (unsigned long long)a << 32 | b;
+	}
+	// Return the set with the specified sorted members
+	static HideSet intern(const members_type &m);
+public:
+	HideSet() : id(0) {}
+	// Return the atom representing the specified token
+	static atom_type atom(const Token &t);
+	// Return the token an atom represents
+	static const Token &get_token(atom_type a) { return tokens[a]; }
+
+	const members_type &members() const { return sets[id]; }
+	bool empty() const { return id == 0; }
+	bool contains(atom_type a) const;
+	// Return the set with a added
+	HideSet insert(atom_type a) const;
+	// Return the union and intersection of this set and s
+	HideSet unite(HideSet s) const;
+	HideSet intersect(HideSet s) const;
+	/*
+	 * Discard all sets and memoized results.
+	 * Only call this when no token with a non-empty hide set exists.
+	 */
+	static void clear();
+	friend bool operator ==(HideSet a, HideSet b) { return a.id == b.id; }
+};
+
+#endif /* HIDESET_ */
@@ -68,6 +68,9 @@
 #include "fileutils.h"
 #include "option.h"
 
+// Output column, for expanding tabs
+static int column = 0;
+
 /*
  * Return as a C string the HTML equivalent of character c
  * Handles tab-stop expansion provided all output is processed through this
@@ -77,7 +80,6 @@ const char *
 html(char c)
 {
 	static char str[2];
-	static int column = 0;
 	static vector<string> spaces(0);
 	int space_idx;
 
@@ -137,6 +139,27 @@ html_string(FILE *of, string s)
 		fputs(html(*i), of);
 }
 
+// Output the len characters of s as HTML in of
+void
+html_text(FILE *of, const char *s, size_t len)
+{
+	const char *run = s;		// Start of characters output verbatim
+	const char *end = s + len;
+
+	for (const char *p = s; p < end; p++)
+		switch (*p) {
+		case '&': case '<': case '>': case '"': case ' ':
+		case '\t': case '\n': case '\r': case '\f':
+			fwrite(run, 1, p - run, of);
+			column += p - run;
+			fputs(html(*p), of);
+			run = p + 1;
+			break;
+		}
+	fwrite(run, 1, end - run, of);
+	column += end - run;
+}
+
 
 // Create a new HTML file with a given filename and title
 // The heading, if not given, will be the same as the title
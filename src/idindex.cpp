@@ -0,0 +1,304 @@
+/*
+ * (C) Copyright 2026 Diomidis Spinellis
+ *
+ * This file is part of CScout.
+ *
+ * CScout is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * CScout is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with CScout.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *
+ * For documentation read the corresponding .h file
+ *
+ */
+
+#include <algorithm>
+#include <cstdint>
+#include <cstring>		// strchr
+#include <map>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "cpp.h"
+#include "debug.h"
+#include "attr.h"
+#include "fileid.h"
+#include "tokid.h"
+#include "eclass.h"
+#include "compiledre.h"
+#include "idquery.h"
+#include "idindex.h"
+
+const size_t IdBitset::npos;
+
+vector <IdProp::iterator> IdIndex::elements;
+vector <IdBitset> IdIndex::attributes;
+IdBitset IdIndex::xfile_set;
+IdBitset IdIndex::unused_set;
+IdBitset IdIndex::writable_set;
+unordered_map <uint32_t, IdIndex::Postings> IdIndex::trigrams;
+map <Fileid, IdIndex::Postings> IdIndex::files;
+
+IdBitset::IdBitset(size_t n, bool v) :
+	bits((n + 63) / 64, v ? ~(uint64_t)0 : 0)
+{
+	// Clear the bits beyond n
+	if (v && n % 64)
+		bits.back() = ((uint64_t)1 << (n % 64)) - 1;
+}
+
+IdBitset &
+IdBitset::operator &=(const IdBitset &b)
+{
+	for (size_t i = 0; i < bits.size(); i++)
+		bits[i] &= b.bits[i];
+	return *this;
+}
+
+IdBitset &
+IdBitset::operator |=(const IdBitset &b)
+{
+	for (size_t i = 0; i < bits.size(); i++)
+		bits[i] |= b.bits[i];
+	return *this;
+}
+
+IdBitset &
+IdBitset::operator -=(const IdBitset &b)
+{
+	for (size_t i = 0; i < bits.size(); i++)
+		bits[i] &= ~b.bits[i];
+	return *this;
+}
+
+size_t
+IdBitset::count() const
+{
+	size_t n = 0;
+	for (size_t i = 0; i < bits.size(); i++)
+		n += __builtin_popcountll(bits[i]);
+	return n;
+}
+
+size_t
+IdBitset::next(size_t i) const
+{
+	size_t w = i / 64;
+	if (w >= bits.size())
+		return npos;
+	uint64_t b = bits[w] & (~(uint64_t)0 << (i % 64));
+	while (!b) {
+		if (++w == bits.size())
+			return npos;
+		b = bits[w];
+	}
+	return w * 64 + __builtin_ctzll(b);
+}
+
+// Return the key of the trigram starting at s
+static inline uint32_t
+trigram(const char *s)
+{
+	return ((uint32_t)(unsigned char)s[0] << 16) |
+		((uint32_t)(unsigned char)s[1] << 8) |
+		(unsigned char)s[2];
+}
+
+void
+IdIndex::build()
+{
+	IdProp &ids(Identifier::ids);
+	size_t n = ids.size();
+	int nattr = Attributes::get_num_attributes();
+
+	elements.clear();
+	elements.reserve(n);
+	attributes.assign(nattr, IdBitset(n));
+	xfile_set = unused_set = writable_set = IdBitset(n);
+	trigrams.clear();
+	files.clear();
+
+	unsigned ord = 0;
+	for (IdProp::iterator i = ids.begin(); i != ids.end(); i++, ord++) {
+		elements.push_back(i);
+		Eclass *e = i->first;
+		for (int a = 0; a < nattr; a++)
+			if (e->get_attribute(a))
+				attributes[a].set(ord);
+		if (i->second.get_xfile())
+			xfile_set.set(ord);
+		if (e->is_unused())
+			unused_set.set(ord);
+		if (!e->get_attribute(is_readonly))
+			writable_set.set(ord);
+
+		const string &name(i->second.get_id());
+		for (string::size_type j = 0; j + 3 <= name.length(); j++) {
+			Postings &p(trigrams[trigram(name.c_str() + j)]);
+			// A name can contain the same trigram more than once
+			if (p.empty() || p.back() != ord)
+				p.push_back(ord);
+		}
+
+		IFSet f(e->sorted_files());
+		for (IFSet::const_iterator j = f.begin(); j != f.end(); j++)
+			files[*j].push_back(ord);
+	}
+	if (DP())
+		cout << "Indexed " << n << " identifiers, " << trigrams.size() << " trigrams" << endl;
+}
+
+size_t
+IdIndex::ordinal(Eclass *ec)
+{
+	update();
+	vector <IdProp::iterator>::const_iterator i = lower_bound(elements.begin(), elements.end(), ec,
+		[](IdProp::iterator a, Eclass *b) { return a->first < b; });
+	if (i == elements.end() || (*i)->first != ec)
+		return elements.size();
+	return i - elements.begin();
+}
+
+const IdBitset &
+IdIndex::attribute(int a)
+{
+	update();
+	// Projects added after the index was built have no identifiers
+	if (a >= (int)attributes.size())
+		attributes.resize(a + 1, IdBitset(elements.size()));
+	return attributes[a];
+}
+
+void
+IdIndex::add_postings(IdBitset &s, const Postings &p)
+{
+	for (Postings::const_iterator i = p.begin(); i != p.end(); i++)
+		s.set(*i);
+}
+
+/*
+ * Add to lits the literal strings of three or more characters that
+ * any string matching the extended regular expression re must contain.
+ * Return false if the expression contains a top-level alternation,
+ * in which case no string is required.
+ * The analysis is conservative: characters within groups, bracket
+ * expressions, and escapes other than those of special characters
+ * break literal strings.
+ */
+static bool
+required_literals(const string &re, vector <string> &lits)
+{
+	string run;
+	int depth = 0;
+
+	auto flush = [&]() {
+		if (run.length() >= 3)
+			lits.push_back(run);
+		run.clear();
+	};
+	for (string::size_type i = 0; i < re.length(); i++) {
+		switch (re[i]) {
+		case '|':
+			if (depth == 0)
+				return false;
+			break;
+		case '(':
+			flush();
+			depth++;
+			break;
+		case ')':
+			if (--depth < 0)
+				return false;
+			break;
+		case '[':
+			flush();
+			// Skip the bracket expression
+			i++;
+			if (i < re.length() && re[i] == '^')
+				i++;
+			if (i < re.length() && re[i] == ']')
+				i++;
+			for (; i < re.length() && re[i] != ']'; i++)
+				if (re[i] == '[' && i + 1 < re.length() &&
+				    (re[i + 1] == ':' || re[i + 1] == '.' || re[i + 1] == '=')) {
+					string::size_type end = re.find(string(1, re[i + 1]) + "]", i + 2);
+					if (end == string::npos)
+						return false;
+					i = end + 1;
+				}
+			break;
+		case '*':
+		case '+':	// Can be followed by another quantifier
+		case '?':
+		case '{':
+			// The preceding character can be absent
+			if (depth == 0 && !run.empty())
+				run.erase(run.length() - 1);
+			flush();
+			if (re[i] == '{' && (i = re.find('}', i)) == string::npos)
+				return false;
+			break;
+		case '.':
+		case '^':
+		case '$':
+			flush();
+			break;
+		case '\\':
+			if (++i == re.length())
+				return false;
+			if (strchr(".[]()*+?{}|^$\\", re[i]) == NULL)
+				flush();
+			else if (depth == 0)
+				run += re[i];
+			break;
+		default:
+			if (depth == 0)
+				run += re[i];
+			break;
+		}
+	}
+	flush();
+	return true;
+}
+
+bool
+IdIndex::name_candidates(const string &re, IdBitset &c)
+{
+	vector <string> lits;
+	if (!required_literals(re, lits) || lits.empty())
+		return false;
+	update();
+	c = IdBitset(elements.size(), true);
+	for (vector <string>::const_iterator i = lits.begin(); i != lits.end(); i++)
+		for (string::size_type j = 0; j + 3 <= i->length(); j++) {
+			unordered_map <uint32_t, Postings>::const_iterator t = trigrams.find(trigram(i->c_str() + j));
+			if (t == trigrams.end()) {
+				c = IdBitset(elements.size());
+				return true;
+			}
+			IdBitset s(elements.size());
+			add_postings(s, t->second);
+			c &= s;
+		}
+	return true;
+}
+
+void
+IdIndex::file_candidates(const CompiledRE &re, IdBitset &c)
+{
+	update();
+	c = IdBitset(elements.size());
+	for (map <Fileid, Postings>::const_iterator i = files.begin(); i != files.end(); i++)
+		if (re.exec(i->first.get_path()) == 0)
+			add_postings(c, i->second);
+}
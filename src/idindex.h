@@ -0,0 +1,118 @@
+/*
+ * (C) Copyright 2026 Diomidis Spinellis
+ *
+ * This file is part of CScout.
+ *
+ * CScout is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * CScout is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with CScout.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *
+ * Inverted indexes over the identifiers of Identifier::ids, used to
+ * restrict the evaluation of identifier queries to a set of candidates.
+ * Identifiers are represented by their ordinal position in Identifier::ids.
+ * The index holds a bitset for every attribute (including projects)
+ * and for the cross-file, unused, and writable properties,
+ * a trigram index over identifier names, used to prefilter regular
+ * expression matches through the literal strings they require, and
+ * the identifiers appearing in each file.
+ *
+ * The indexed properties do not change after the identifiers have
+ * been processed; the index is rebuilt if identifiers are added.
+ *
+ */
+
+#ifndef IDINDEX_
+#define IDINDEX_
+
+#include <cstdint>
+#include <map>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+using namespace std;
+
+#include "fileid.h"
+#include "compiledre.h"
+#include "idquery.h"
+
+// A set of identifiers, represented by their ordinal numbers
+class IdBitset {
+private:
+	vector <uint64_t> bits;
+public:
+	IdBitset() {}
+	// Construct a set over n elements, all of them members if v is true
+	explicit IdBitset(size_t n, bool v = false);
+	void set(size_t i) { bits[i / 64] |= (uint64_t)1 << (i % 64); }
+	bool test(size_t i) const { return (bits[i / 64] >> (i % 64)) & 1; }
+	IdBitset &operator &=(const IdBitset &b);
+	IdBitset &operator |=(const IdBitset &b);
+	IdBitset &operator -=(const IdBitset &b);
+	static const size_t npos = (size_t)-1;
+	// Return the number of members
+	size_t count() const;
+	// Return the first member not less than i, or npos if there is none
+	size_t next(size_t i) const;
+	// Call f(i) for every member i in increasing order
+	template <typename F>
+	void for_each(F f) const {
+		for (size_t w = 0; w < bits.size(); w++)
+			for (uint64_t b = bits[w]; b; b &= b - 1)
+				f(w * 64 + __builtin_ctzll(b));
+	}
+};
+
+class IdIndex {
+private:
+	typedef vector <unsigned> Postings;	// Ordered identifier ordinals
+	static vector <IdProp::iterator> elements;	// Identifiers by ordinal
+	static vector <IdBitset> attributes;	// Identifiers having each attribute
+	static IdBitset xfile_set, unused_set, writable_set;
+	static unordered_map <uint32_t, Postings> trigrams;	// Names containing each trigram
+	static map <Fileid, Postings> files;	// Identifiers appearing in each file
+
+	// Rebuild the index if the identifiers have changed
+	static void update() {
+		if (elements.size() != Identifier::ids.size())
+			build();
+	}
+	// Add to s the identifiers in p
+	static void add_postings(IdBitset &s, const Postings &p);
+public:
+	// Build the index from the current identifiers
+	static void build();
+	// Return the number of indexed identifiers
+	static size_t size() { update(); return elements.size(); }
+	// Return the identifier with ordinal i
+	static IdPropElem &element(size_t i) { return *elements[i]; }
+	// Return the ordinal of ec's identifier or size() if there is none
+	static size_t ordinal(Eclass *ec);
+	// Return the identifiers having the attribute or project a
+	static const IdBitset &attribute(int a);
+	// Return the identifiers having the corresponding property
+	static const IdBitset &xfile() { update(); return xfile_set; }
+	static const IdBitset &unused() { update(); return unused_set; }
+	static const IdBitset &writable() { update(); return writable_set; }
+	/*
+	 * Set c to a superset of the identifiers whose name matches
+	 * the extended regular expression re.
+	 * Return false if the expression provides no means to
+	 * restrict the set.
+	 */
+	static bool name_candidates(const string &re, IdBitset &c);
+	// Set c to the identifiers appearing in files whose path matches re
+	static void file_candidates(const CompiledRE &re, IdBitset &c);
+};
+
+#endif /* IDINDEX_ */
@@ -70,6 +70,7 @@
 #include "option.h"
 #include "query.h"
 #include "idquery.h"
+#include "idindex.h"
 
 IdProp Identifier::ids;
 
@@ -309,3 +310,99 @@ IdQuery::eval(const IdPropElem &i)
 	}
 	return true;
 }
+
+/*
+ * Set c to a superset of the identifiers for which eval returns true,
+ * using the identifier index.
+ * The attributes and properties are matched exactly; the regular
+ * expressions are only used to prefilter the identifiers.
+ */
+void
+IdQuery::candidates(IdBitset &c) const
+{
+	size_t n = IdIndex::size();
+
+	if (lazy) {
+		c = IdBitset(n, return_val);
+		return;
+	}
+	if (ec) {
+		c = IdBitset(n);
+		size_t i = IdIndex::ordinal(ec);
+		if (i != n)
+			c.set(i);
+		return;
+	}
+	c = IdBitset(n, true);
+	if (current_project)
+		c &= IdIndex::attribute(current_project);
+	IdBitset names;
+	if (match_ire && !exclude_ire && IdIndex::name_candidates(str_ire, names))
+		c &= names;
+	switch (match_type) {
+	case 'Y':	// anY match
+		{
+			IdBitset any(n);
+			for (int j = attr_begin; j < attr_end; j++)
+				if (match[j])
+					any |= IdIndex::attribute(j);
+			if (xfile)
+				any |= IdIndex::xfile();
+			if (unused)
+				any |= IdIndex::unused();
+			if (writable)
+				any |= IdIndex::writable();
+			c &= any;
+		}
+		break;
+	case 'L':	// alL match
+		for (int j = attr_begin; j < attr_end; j++)
+			if (match[j])
+				c &= IdIndex::attribute(j);
+		if (xfile)
+			c &= IdIndex::xfile();
+		if (unused)
+			c &= IdIndex::unused();
+		if (writable)
+			c &= IdIndex::writable();
+		break;
+	case 'E':	// excludE match
+		for (int j = attr_begin; j < attr_end; j++)
+			if (match[j])
+				c -= IdIndex::attribute(j);
+		if (xfile)
+			c -= IdIndex::xfile();
+		if (unused)
+			c -= IdIndex::unused();
+		if (writable)
+			c -= IdIndex::writable();
+		break;
+	case 'T':	// exactT match
+		for (int j = attr_begin; j < attr_end; j++)
+			if (match[j])
+				c &= IdIndex::attribute(j);
+			else
+				c -= IdIndex::attribute(j);
+		if (xfile)
+			c &= IdIndex::xfile();
+		else
+			c -= IdIndex::xfile();
+		if (unused)
+			c &= IdIndex::unused();
+		else
+			c -= IdIndex::unused();
+		if (writable)
+			c &= IdIndex::writable();
+		else
+			c -= IdIndex::writable();
+		break;
+	}
+	if (match_fre) {
+		IdBitset f;
+		IdIndex::file_candidates(fre, f);
+		if (exclude_fre)
+			c -= f;
+		else
+			c &= f;
+	}
+}
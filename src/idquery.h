@@ -34,6 +34,7 @@ using namespace std;
 #include "filedetails.h"
 
 class Identifier;
+class IdBitset;
 
 typedef map <Eclass *, Identifier> IdProp;
 
@@ -111,6 +112,8 @@ public:
 
 	// Perform a query
 	bool eval(const IdPropElem &i);
+	// Set c to a superset of the identifiers for which eval returns true
+	void candidates(IdBitset &c) const;
 	// Return the URL for re-executing this query
 	string base_url() const;
 	// Return the query's parameters as a URL
@@ -0,0 +1,122 @@
+/*
+ * (C) Copyright 2026 Diomidis Spinellis
+ *
+ * This file is part of CScout.
+ *
+ * CScout is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * CScout is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with CScout.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *
+ * For documentation read the corresponding .h file
+ *
+ */
+
+#include <fstream>
+#include <map>
+#include <memory>
+#include <string>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
+#include <errno.h>
+// Not on macOS, whose file names are by default case-insensitive
+#if (defined(unix) || defined(__unix__)) && !defined(__MACH__)
+#define HAVE_DIRENT
+#include <dirent.h>
+#endif
+
+#include "inccache.h"
+#include "os.h"
+
+unordered_map <string, bool> IncludeCache::files;
+unordered_map <string, unique_ptr <unordered_set <string> > > IncludeCache::dirs;
+map <IncludeCache::Path, int> IncludeCache::paths;
+int IncludeCache::path_id = -1;
+unordered_map <string, int> IncludeCache::searches;
+
+string
+IncludeCache::qualify(const string &path)
+{
+	if (!path.empty() && path[0] == '/')
+		return path;
+	return get_current_dir() + '/' + path;
+}
+
+bool
+IncludeCache::may_exist(const string &dir, const string &name)
+{
+#ifdef HAVE_DIRENT
+	unordered_map <string, unique_ptr <unordered_set <string> > >::iterator i = dirs.find(dir);
+	if (i == dirs.end()) {
+		unique_ptr <unordered_set <string> > names;
+		DIR *d = opendir(dir.empty() ? "/" : dir.c_str());
+		if (d) {
+			names.reset(new unordered_set <string>);
+			struct dirent *e;
+			while ((e = readdir(d)) != NULL)
+				names->insert(e->d_name);
+			closedir(d);
+		} else if (errno == ENOENT || errno == ENOTDIR)
+			names.reset(new unordered_set <string>);	// Nothing is there
+		i = dirs.insert(make_pair(dir, std::move(names))).first;
+	}
+	return !i->second || i->second->count(name);
+#else
+	return true;
+#endif
+}
+
+bool
+IncludeCache::can_open(const string &path)
+{
+	string qpath(qualify(path));
+	unordered_map <string, bool>::const_iterator i = files.find(qpath);
+	if (i != files.end())
+		return i->second;
+
+	bool r;
+	string::size_type slash = qpath.rfind('/');
+	if (!may_exist(qpath.substr(0, slash), qpath.substr(slash + 1)))
+		r = false;
+	else {
+		ifstream in(path.c_str());
+		r = !in.fail();
+	}
+	files.insert(make_pair(qpath, r));
+	return r;
+}
+
+int
+IncludeCache::search(const vector <string> &p, int start, const string &name)
+{
+	if (path_id == -1) {
+		map <Path, int>::const_iterator i = paths.find(p);
+		if (i == paths.end())
+			i = paths.insert(make_pair(p, (int)paths.size())).first;
+		path_id = i->second;
+	}
+
+	string key(qualify(to_string(path_id) + ' ' + to_string(start) + ' ' + name));
+	unordered_map <string, int>::const_iterator i = searches.find(key);
+	if (i != searches.end())
+		return i->second;
+
+	int r = -1;
+	for (int j = start; j < (int)p.size(); j++)
+		if (can_open(p[j] + "/" + name)) {
+			r = j;
+			break;
+		}
+	searches.insert(make_pair(key, r));
+	return r;
+}
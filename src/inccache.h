@@ -0,0 +1,77 @@
+/*
+ * (C) Copyright 2026 Diomidis Spinellis
+ *
+ * This file is part of CScout.
+ *
+ * CScout is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * CScout is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with CScout.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *
+ * A cache of the results of resolving #include directives.
+ * Whether a file can be opened is determined only once for each path,
+ * so negative results, which are the vast majority when searching
+ * a long include path, are also cached.
+ * Where supported, the names in each directory are listed once,
+ * so that files missing from a directory are found to be missing
+ * without trying to open them.
+ * Searches of the include path are cached by the path, the position
+ * from which the search starts, and the file's name; once a header has
+ * been resolved, resolving it again costs a single hash table lookup.
+ *
+ * Relative paths are cached together with the current directory,
+ * which the processing script can change through #pragma pushd.
+ * The cache assumes that no files are created or removed while
+ * the workspace is being processed.
+ *
+ */
+
+#ifndef INCCACHE_
+#define INCCACHE_
+
+#include <map>
+#include <memory>
+#include <string>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
+
+using namespace std;
+
+class IncludeCache {
+private:
+	typedef vector <string> Path;
+	static unordered_map <string, bool> files;	// Whether paths can be opened
+	// Names in each directory; NULL if the directory cannot be listed
+	static unordered_map <string, unique_ptr <unordered_set <string> > > dirs;
+	static map <Path, int> paths;	// Identifiers of include paths seen
+	static int path_id;		// Identifier of the current path; -1 if unknown
+	// Positions of the files found in include path searches
+	static unordered_map <string, int> searches;
+	// Return path qualified by the current directory
+	static string qualify(const string &path);
+
+	// Return false if the directory's listing shows that name is not in it
+	static bool may_exist(const string &dir, const string &name);
+public:
+	// Return true if the file at the specified path can be opened
+	static bool can_open(const string &path);
+	// Called when the include path changes
+	static void path_changed() { path_id = -1; }
+	/*
+	 * Return the position in include path p, starting from start, of
+	 * the first directory containing the file name; -1 if there is none.
+	 */
+	static int search(const vector <string> &p, int start, const string &name);
+};
+
+#endif /* INCCACHE_ */
@@ -0,0 +1,117 @@
+/*
+ * (C) Copyright 2026 Diomidis Spinellis
+ *
+ * This file is part of CScout.
+ *
+ * CScout is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * CScout is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with CScout.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *
+ * For documentation read the corresponding .h file
+ *
+ */
+
+#include <cmath>
+#include <cstdio>
+#include <string>
+
+#include "json.h"
+
+/*
+ * Return the length of the valid UTF-8 sequence starting at s[i],
+ * or 0 if the bytes there do not form one.
+ * Overlong encodings, surrogates, and values above U+10FFFF are invalid.
+ */
+static int
+utf8_length(const string &s, string::size_type i)
+{
+	unsigned char c = s[i];
+	int len;
+	unsigned min;
+
+	if (c < 0x80)
+		return 1;
+	else if ((c & 0xe0) == 0xc0) {
+		len = 2;
+		min = 0x80;
+	} else if ((c & 0xf0) == 0xe0) {
+		len = 3;
+		min = 0x800;
+	} else if ((c & 0xf8) == 0xf0) {
+		len = 4;
+		min = 0x10000;
+	} else
+		return 0;
+	if (i + len > s.length())
+		return 0;
+	unsigned v = c & (0x7f >> len);
+	for (int j = 1; j < len; j++) {
+		unsigned char cc = s[i + j];
+		if ((cc & 0xc0) != 0x80)
+			return 0;
+		v = (v << 6) | (cc & 0x3f);
+	}
+	if (v < min || v > 0x10ffff || (v >= 0xd800 && v <= 0xdfff))
+		return 0;
+	return len;
+}
+
+/*
+ * Bytes that are not valid UTF-8 (e.g. source code in Latin-1)
+ * are replaced by U+FFFD, so that the result is always valid JSON.
+ */
+string
+json(const string &s)
+{
+	string r("\"");
+
+	for (string::size_type i = 0; i < s.length(); i++)
+		switch (s[i]) {
+		case '"': r += "\\\""; break;
+		case '\\': r += "\\\\"; break;
+		case '\b': r += "\\b"; break;
+		case '\f': r += "\\f"; break;
+		case '\n': r += "\\n"; break;
+		case '\r': r += "\\r"; break;
+		case '\t': r += "\\t"; break;
+		default:
+			if ((unsigned char)s[i] < 0x20) {
+				char buff[8];
+				snprintf(buff, sizeof(buff), "\\u%04x", (unsigned char)s[i]);
+				r += buff;
+			} else if ((unsigned char)s[i] < 0x80)
+				r += s[i];
+			else if (int len = utf8_length(s, i)) {
+				r.append(s, i, len);
+				i += len - 1;
+			} else
+				r += "\xef\xbf\xbd";	// U+FFFD REPLACEMENT CHARACTER
+		}
+	return r + '"';
+}
+
+string
+json(double v)
+{
+	if (!std::isfinite(v))
+		return "null";
+	char buff[32];
+	snprintf(buff, sizeof(buff), "%.15g", v);
+	return buff;
+}
+
+void
+json_error(FILE *of, const string &msg)
+{
+	fprintf(of, "{\"error\": %s}\n", json(msg).c_str());
+}
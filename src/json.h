@@ -0,0 +1,103 @@
+/*
+ * (C) Copyright 2026 Diomidis Spinellis
+ *
+ * This file is part of CScout.
+ *
+ * CScout is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * CScout is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with CScout.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *
+ * Helpers for generating the JSON documents returned by the
+ * web interface's API pages (api/ids, api/funs, api/files, api/metrics).
+ *
+ */
+
+#ifndef JSON_
+#define JSON_
+
+#include <cstdio>
+#include <string>
+
+using namespace std;
+
+#include "metrics.h"
+
+// Return s as a quoted and escaped JSON string; invalid UTF-8 becomes U+FFFD
+string json(const string &s);
+// Return v as a JSON number; null if it is not finite
+string json(double v);
+// Output a JSON document reporting the error msg
+void json_error(FILE *of, const string &msg);
+
+/*
+ * Output the values of an element's metrics as a JSON object,
+ * keyed by the metrics' database field names.
+ */
+template <class M>
+void
+json_metrics(FILE *of, const M &pre_cpp, const M &post_cpp)
+{
+	const char *sep = "";
+
+	fputs("{\"pre_cpp\": {", of);
+	for (int i = 0; i < M::metric_max; i++)
+		if (Metrics::is_pre_cpp<M>(i)) {
+			fprintf(of, "%s\"%s\": %s", sep,
+			    Metrics::get_dbfield<M>(i).c_str(),
+			    json(pre_cpp.get_metric(i)).c_str());
+			sep = ", ";
+		}
+	fputs("}, \"post_cpp\": {", of);
+	sep = "";
+	for (int i = 0; i < M::metric_max; i++)
+		if (Metrics::is_post_cpp<M>(i)) {
+			fprintf(of, "%s\"%s\": %s", sep,
+			    Metrics::get_dbfield<M>(i).c_str(),
+			    json(post_cpp.get_metric(i)).c_str());
+			sep = ", ";
+		}
+	fputs("}}", of);
+}
+
+// Output the summary of a metrics range as a JSON object
+template <class M, class E>
+void
+json_metrics(FILE *of, const MetricsRange<M, E> &m)
+{
+	int n = m.total.get_nelement();
+	const char *sep = "";
+
+	fprintf(of, "{\"elements\": %d, \"metrics\": {", n);
+	for (int i = 0; i < M::metric_max; i++) {
+		if (Metrics::is_internal<M>(i))
+			continue;
+		fprintf(of, "%s\"%s\": {", sep, Metrics::get_dbfield<M>(i).c_str());
+		sep = ", ";
+		if (Metrics::is_pre_cpp<M>(i))
+			fprintf(of, "\"pre_cpp\": {\"total\": %s, \"min\": %s, \"max\": %s}",
+			    json(m.total.get_pre_cpp_metric(i)).c_str(),
+			    json(n ? m.min.get_pre_cpp_metric(i) : 0).c_str(),
+			    json(m.max.get_pre_cpp_metric(i)).c_str());
+		if (Metrics::is_pre_cpp<M>(i) && Metrics::is_post_cpp<M>(i))
+			fputs(", ", of);
+		if (Metrics::is_post_cpp<M>(i))
+			fprintf(of, "\"post_cpp\": {\"total\": %s, \"min\": %s, \"max\": %s}",
+			    json(m.total.get_post_cpp_metric(i)).c_str(),
+			    json(n ? m.min.get_post_cpp_metric(i) : 0).c_str(),
+			    json(m.max.get_post_cpp_metric(i)).c_str());
+		fputs("}", of);
+	}
+	fputs("}}", of);
+}
+
+#endif /* JSON_ */
@@ -0,0 +1,157 @@
+/*
+ * (C) Copyright 2026 Diomidis Spinellis
+ *
+ * This file is part of CScout.
+ *
+ * CScout is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * CScout is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with CScout.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *
+ * For documentation read the corresponding .h file
+ *
+ */
+
+#include <cstring>
+#include <initializer_list>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "keyword.h"
+
+bool
+KeywordTable::fill(const vector <Entry> &keywords)
+{
+	table.assign(mask + 1, Entry());
+	for (vector <Entry>::const_iterator i = keywords.begin(); i != keywords.end(); i++) {
+		Entry &e = table[hash(i->name, i->len)];
+		if (e.len)
+			return false;
+		e = *i;
+	}
+	return true;
+}
+
+KeywordTable::KeywordTable(initializer_list <pair <const char *, int> > k) :
+	mask(0), seed(0), minlen(~(size_t)0), maxlen(0)
+{
+	vector <Entry> keywords;
+
+	for (auto i = k.begin(); i != k.end(); i++) {
+		Entry e;
+		e.name = i->first;
+		e.len = strlen(i->first);
+		e.value = i->second;
+		keywords.push_back(e);
+		if (e.len < minlen)
+			minlen = e.len;
+		if (e.len > maxlen)
+			maxlen = e.len;
+	}
+
+	// Start with a sparse table, and grow it if no seed works
+	for (mask = 1; mask < keywords.size() * 4; mask <<= 1)
+		;
+	mask--;
+	for (;;) {
+		for (seed = 0; seed < 100000; seed++)
+			if (fill(keywords))
+				return;
+		mask = mask * 2 + 1;
+	}
+}
+
+#ifdef TEST
+/*
+ * Benchmark keyword lookups over the identifiers of real source files
+ * against the std::map they replaced, both built from the C keywords.
+ * After parse.tab.h has been generated by the build, run
+ * c++ -O2 -DTEST keyword.cpp -o keyword-bench && ./keyword-bench *.cpp
+ */
+#include <chrono>
+#include <fstream>
+#include <iostream>
+#include <iterator>
+#include <map>
+#include <cctype>
+
+#include "ckeywords.h"
+
+int
+main(int argc, char *argv[])
+{
+	vector <string> ids;
+
+	// Collect the identifiers appearing in the specified files
+	for (int i = 1; i < argc; i++) {
+		ifstream in(argv[i]);
+		string s((istreambuf_iterator<char>(in)), istreambuf_iterator<char>());
+		for (string::size_type j = 0; j < s.length(); ) {
+			if (isalpha((unsigned char)s[j]) || s[j] == '_') {
+				string::size_type k = j;
+				while (k < s.length() && (isalnum((unsigned char)s[k]) || s[k] == '_'))
+					k++;
+				ids.push_back(s.substr(j, k - j));
+				j = k;
+			} else if (isdigit((unsigned char)s[j])) {
+				while (j < s.length() && (isalnum((unsigned char)s[j]) || s[j] == '_'))
+					j++;
+			} else
+				j++;
+		}
+	}
+	if (ids.empty()) {
+		cerr << "usage: " << argv[0] << " file ..." << endl;
+		return 1;
+	}
+
+	map <string, int> m;
+	for (auto i = c_keywords.begin(); i != c_keywords.end(); i++)
+		m[i->first] = i->second;
+	KeywordTable t(c_keywords);
+
+	const int rounds = 20;
+	long mkeys = 0, tkeys = 0;	// Keywords found
+	auto start = chrono::steady_clock::now();
+	for (int r = 0; r < rounds; r++)
+		for (vector <string>::const_iterator i = ids.begin(); i != ids.end(); i++) {
+			map <string, int>::const_iterator k = m.find(*i);
+			if (k != m.end())
+				mkeys++;
+		}
+	auto middle = chrono::steady_clock::now();
+	for (int r = 0; r < rounds; r++)
+		for (vector <string>::const_iterator i = ids.begin(); i != ids.end(); i++) {
+			int k = t.lookup(*i);
+			if (k != -1)
+				tkeys++;
+		}
+	auto end = chrono::steady_clock::now();
+
+	// Verify that both agree on every identifier
+	for (vector <string>::const_iterator i = ids.begin(); i != ids.end(); i++) {
+		map <string, int>::const_iterator k = m.find(*i);
+		if ((k == m.end() ? -1 : k->second) != t.lookup(*i)) {
+			cerr << "Mismatch on " << *i << endl;
+			return 1;
+		}
+	}
+
+	double mt = chrono::duration<double, nano>(middle - start).count() / rounds / ids.size();
+	double tt = chrono::duration<double, nano>(end - middle).count() / rounds / ids.size();
+	cout << ids.size() << " identifiers, " << (mkeys / rounds) << " keywords\n";
+	cout << "std::map:     " << mt << " ns/lookup\n";
+	cout << "KeywordTable: " << tt << " ns/lookup (" << mt / tt << "x)\n";
+	return (mkeys == tkeys) ? 0 : 1;
+}
+#endif /* TEST */
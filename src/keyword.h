@@ -0,0 +1,83 @@
+/*
+ * (C) Copyright 2026 Diomidis Spinellis
+ *
+ * This file is part of CScout.
+ *
+ * CScout is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * CScout is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with CScout.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *
+ * A perfect hash table for recognizing keywords.
+ * The table is built once, when it is constructed, by trying hash
+ * function seeds until one maps every keyword to a different slot.
+ * The hash function only combines the length of a string with four
+ * of its characters, so looking up an identifier costs a few
+ * operations.  Strings are rejected by their length and first character
+ * before they are compared with the keyword occupying their slot.
+ *
+ */
+
+#ifndef KEYWORD_
+#define KEYWORD_
+
+#include <cstring>
+#include <initializer_list>
+#include <string>
+#include <utility>
+#include <vector>
+
+using namespace std;
+
+class KeywordTable {
+private:
+	struct Entry {
+		const char *name;	// Keyword; empty for free slots
+		size_t len;		// Its length; 0 for free slots
+		int value;		// Its token value
+		Entry() : name(""), len(0), value(-1) {}
+	};
+	vector <Entry> table;		// Keywords indexed by their hash
+	unsigned mask;			// Table size minus one
+	unsigned seed;			// Seed making the hash perfect
+	size_t minlen, maxlen;		// Shortest and longest keyword length
+
+	// Return the table slot of the len bytes at s
+	unsigned hash(const char *s, size_t len) const {
+		unsigned h = seed ^ (unsigned)len;
+		h = (h ^ (unsigned char)s[0]) * 0x01000193u;
+		h = (h ^ (unsigned char)s[(len - 1) / 2]) * 0x01000193u;
+		h = (h ^ (unsigned char)s[len / 2]) * 0x01000193u;
+		h = (h ^ (unsigned char)s[len - 1]) * 0x01000193u;
+		return (h ^ (h >> 16)) & mask;
+	}
+	// Try to place all keywords using the current seed
+	bool fill(const vector <Entry> &keywords);
+public:
+	// Build the table of the specified keywords and their values
+	KeywordTable(initializer_list <pair <const char *, int> > keywords);
+	/*
+	 * Return the keyword value of the len bytes at s
+	 * or -1 if they aren't a keyword.
+	 */
+	int lookup(const char *s, size_t len) const {
+		if (len < minlen || len > maxlen)
+			return -1;
+		const Entry &e = table[hash(s, len)];
+		if (e.len != len || e.name[0] != s[0] || memcmp(e.name, s, len) != 0)
+			return -1;
+		return e.value;
+	}
+	int lookup(const string &s) const { return lookup(s.data(), s.length()); }
+};
+
+#endif /* KEYWORD_ */
@@ -347,6 +347,7 @@ Macro::register_macro_body(mapMacroBody &map) const
 // Constructor
 Macro::Macro( const Ptoken& name, bool id, bool isfun, bool isimmutable) :
 	name_token(name),
+	hideset_atom(HideSet::atom(name)),
 	is_function(isfun),
 	is_immutable(isimmutable),
 	is_vararg(false),
@@ -408,7 +409,7 @@ macro_expand(PtokenSequence ts, bool get_more, bool skip_defined, const Macro *c
 		}
 
 		const Macro& m = mi->second;
-		if (head.hideset_contains(m.get_name_token())) {
+		if (head.hideset_contains(m.get_hideset_atom())) {
 			// Skip the head token if it is in the hideset
 			if (DP()) cout << "Skipping (head is in HS)" << endl;
 			r.push_back(head);
@@ -420,8 +421,7 @@ macro_expand(PtokenSequence ts, bool get_more, bool skip_defined, const Macro *c
 		if (!m.is_function) {
 			// Object-like macro
 			Token::unify((*mi).second.name_token, head);
-			HideSet hs(head.get_hideset());
-			hs.insert(m.get_name_token());
+			HideSet hs(head.get_hideset().insert(m.get_hideset_atom()));
 			PtokenSequence s(subst(m, m.value, mapArgval(), hs, skip_defined, caller));
 			ts.splice(ts.begin(), s);
 			caller = &m;
@@ -442,11 +442,7 @@ macro_expand(PtokenSequence ts, bool get_more, bool skip_defined, const Macro *c
 			Ptoken close;
 			if (!gather_args(name, ts, m.formal_args, args, get_more, m.is_vararg, close))
 				continue;	// Attempt to bail-out on error
-			HideSet hs;
-			set_intersection(head.get_hideset().begin(), head.get_hideset().end(),
-				close.get_hideset().begin(), close.get_hideset().end(),
-				inserter(hs, hs.begin()));
-			hs.insert(m.get_name_token());
+			HideSet hs(head.get_hideset().intersect(close.get_hideset()).insert(m.get_hideset_atom()));
 			PtokenSequence s(subst(m, m.value, args, hs, skip_defined, caller));
 			ts.splice(ts.begin(), s);
 			caller = &m;
@@ -570,7 +566,7 @@ subst(const Macro &m, dequePtoken is, const mapArgval &args, HideSet hs, bool sk
 
 	// Add hs to the hide set of every element of os
 	for (PtokenSequence::iterator oi = os.begin(); oi != os.end(); ++oi)
-		oi->hideset_insert(hs.begin(), hs.end());
+		oi->hideset_insert(hs);
 	if (DP()) cout << "os after adding hs: " << os << endl;
 
 	return os;
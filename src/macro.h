@@ -53,6 +53,7 @@ typedef map<Tokid, MCall *> mapMacroBody;
 class Macro {
 private:
 	Ptoken name_token;		// Name (used for unification)
+	HideSet::atom_type hideset_atom;	// Name as a hide set member
 	bool is_function;		// True if it is a function-macro
 	bool is_immutable;		// Immutably-defined macro
 	bool is_vararg;			// True if the function has variable # of arguments (gcc)
@@ -65,6 +66,7 @@ public:
 	Macro( const Ptoken& name, bool id, bool is_function, bool is_immutable);
 	// Accessor functions
 	const Ptoken& get_name_token() const {return name_token; };
+	HideSet::atom_type get_hideset_atom() const { return hideset_atom; }
 	void set_is_function(bool v) { is_function = v; };
 	void set_is_vararg(bool v) { is_vararg = v; };
 	bool get_is_defined() const { return is_defined; };
@@ -18,7 +18,7 @@
  *
  *
  * A class processing macro arguments when the files are being post-processed
- * and setting the em_nneparam metric.
+ * and collecting the values of the em_nneparam metric.
  * This is incremented for the first token of each parameter that cannot
  * be part of a C expression.  This means C keywords, structure tags,
  * structure members, and typedefs.  Such macros definitely cannot
@@ -26,12 +26,15 @@
  * Only the first token of each parameter is checked, because
  * macro(int, double) is problematic, whereas
  * macro((int)a, (double)b) isn't.
+ * As the macros can be defined in other files, the metric values are
+ * not set directly, but are appended to a vector supplied by the caller.
  *
  */
 
 #ifndef MACRO_ARG_PROCESSOR_
 #define MACRO_ARG_PROCESSOR_
 
+#include <utility>
 #include <vector>
 
 using namespace std;
@@ -60,18 +63,22 @@ private:
 	// ECs for macro name
 	Call::name_identifier macro_name_ecs;
 
+	// Macros and their em_nneparam values to add
+	vector <pair <Call *, int> > &nneparam;
+
 	// Called after the macro's parameters have been processed
 	void finish_processing(void) {
 		mstate = ma_scan_for_macro_name;
 		Call* macro = Call::get_macro(macro_name_ecs);
 		if (macro)
-			macro->get_pre_cpp_metrics().add_metric(FunMetrics::em_nneparam, non_obj_param);
+			nneparam.push_back(make_pair(macro, non_obj_param));
 	}
 
 public:
-	// Construct object in initial state
-	MacroArgProcessor() : bracket_nesting(0), non_obj_param(0),
-	    mstate(ma_scan_for_macro_name) {}
+	// Construct object in initial state, collecting results into n
+	MacroArgProcessor(vector <pair <Call *, int> > &n) :
+	    bracket_nesting(0), non_obj_param(0),
+	    mstate(ma_scan_for_macro_name), nneparam(n) {}
 
 	// Call for every character being processed
 	void process_char(enum e_cfile_state cstate, char c) {
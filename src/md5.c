@@ -334,6 +334,26 @@ MD5File(const char *fname)
 	return (md.digest);
 }
 
+/*
+ * Calculate the MD-5 of the len bytes at buf
+ * Return a pointer to 16 bytes comprising the result
+ */
+unsigned char *
+MD5Buffer(const unsigned char *buf, size_t len)
+{
+	static MD5_CTX md;
+	unsigned n;
+
+	memset(&md, 0, sizeof(md));
+	MD5Init(&md);
+	for (; len > 0; buf += n, len -= n) {
+		n = len > 0x10000000 ? 0x10000000 : (unsigned)len;
+		MD5Update(&md, (unsigned char *)buf, n);
+	}
+	MD5Final(&md);
+	return (md.digest);
+}
+
 #ifdef TEST
 int
 main(int argc, char *argv[])
@@ -43,6 +43,7 @@
  ***********************************************************************
  */
 
+#include <stddef.h>
 
 #ifdef __cplusplus
 extern "C" {
@@ -63,6 +64,7 @@ void MD5Init ();
 void MD5Update ();
 void MD5Final ();
 unsigned char * MD5File(const char *fname);
+unsigned char * MD5Buffer(const unsigned char *buf, size_t len);
 
 #ifdef __cplusplus
 }
@@ -206,11 +206,11 @@ IdCount::add(Eclass *ec, UnaryFunction f)
 			count[i] = f(count[i]);
 }
 
-// Called for each identifier occurence (all)
+// Called for each identifier occurence (all), or for n of them
 void
-IdMetricsSummary::add_pre_cpp_id(Eclass *ec)
+IdMetricsSummary::add_pre_cpp_id(Eclass *ec, int n)
 {
-	rw[ec->get_attribute(is_readonly)].all[IdMetricsSet::pp_pre].add(ec, add_one());
+	rw[ec->get_attribute(is_readonly)].all[IdMetricsSet::pp_pre].add(ec, add_n(n));
 }
 
 void
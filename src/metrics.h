@@ -465,8 +465,8 @@ private:
 class IdMetricsSummary {
 	IdMetricsSet rw[2];			// For writable (0) and read-only (1) cases
 public:
-	// Called for every identifier occurence
-	void add_pre_cpp_id(Eclass *ec);
+	// Called for every identifier occurence, or with their number
+	void add_pre_cpp_id(Eclass *ec, int n = 1);
 	void add_post_cpp_id(Eclass *ec);
 
 	// Called for every unique identifier occurence (EC)
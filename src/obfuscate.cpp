@@ -217,7 +217,7 @@ file_obfuscate(Fileid fid)
 	fifstream in;
 	ofstream out;
 
-	in.open(fid.get_path().c_str(), ios::binary);
+	in.open(fid);
 	if (in.fail()) {
 		perror(fid.get_path().c_str());
 		exit(1);
@@ -70,7 +70,9 @@ TextOption *Option::sfile_repl_string;		// Saved files replacement string
 TextOption *Option::start_editor_cmd;		// Command to invoke an external editor
 IntegerOption *Option::entries_per_page;	// Number of elements to show in a page
 IntegerOption *Option::cgraph_depth;		// How deep to descend in a call graph
+IntegerOption *Option::cpath_visits;		// Functions to visit when searching call paths
 IntegerOption *Option::fgraph_depth;		// How deep to descend in an include graph
+IntegerOption *Option::page_cache_size;		// Size of the generated page cache (MB)
 BoolOption *Option::cgraph_dot_url;		// Include URLs in dot output
 vector<Option *> Option::options;		// Options in the order they were added
 map<string, Option *> Option::omap;		// For loading options
@@ -230,6 +232,7 @@ Option::initialize()
 
 	Option::add(new TitleOption("Queries"));
 	Option::add(file_icase = new BoolOption("file_icase", "Case-insensitive file name regular expression match"));
+	Option::add(page_cache_size = new IntegerOption("page_cache_size", "Size of the query and graph page cache (MB; 0 disables it)", 64, 0));
 
 	Option::add(new TitleOption("Query Result Lists"));
 	Option::add(entries_per_page = new IntegerOption("entries_per_page", "Number of entries on a page", 50));
@@ -263,6 +266,7 @@ Option::initialize()
 		NULL));
 	Option::add(cgraph_depth = new IntegerOption("cgraph_depth", "Maximum number of call levels in a call graph", 5));
 	Option::add(fgraph_depth = new IntegerOption("fgraph_depth", "Maximum dependency depth in a file graph", 5));
+	Option::add(cpath_visits = new IntegerOption("cpath_visits", "Thousands of functions visited when searching for call paths (0 for no limit)", 1000, 0));
 	Option::add(cgraph_dot_url = new BoolOption("cgraph_dot_url", "Include URLs in dot output", false));
 	Option::add(dot_graph_options = new TextOption("dot_graph_options", "Graph options"));
 	Option::add(dot_node_options = new TextOption("dot_node_options", "Node options"));
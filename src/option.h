@@ -102,7 +102,9 @@ public:
 	static TextOption *start_editor_cmd;		// Command to invoke an external editor
 	static IntegerOption *entries_per_page;		// Number of elements to show in a page
 	static IntegerOption *cgraph_depth;		// How deep to descend in a call graph
+	static IntegerOption *cpath_visits;		// Functions to visit when searching call paths
 	static IntegerOption *fgraph_depth;		// How deep to descend in a file graph
+	static IntegerOption *page_cache_size;		// Size of the generated page cache (MB)
 	static BoolOption *cgraph_dot_url;		// Include URLs in dot output
 	// Initialize the global web options
 	static void initialize();
@@ -205,8 +207,9 @@ class IntegerOption : public Option {
 private:
 	int	v;		// The value
 public:
+	int	min_v;		// The minimum value that can be set
 	// Constructor
-	IntegerOption(const char *sn, const char *un, int iv) : Option(sn, un), v(iv) {}
+	IntegerOption(const char *sn, const char *un, int iv, int mv = 1) : Option(sn, un), v(iv), min_v(mv) {}
 	// Save to a file
 	void save(ofstream &ofs) const { ofs << v; }
 	// Load from a file
@@ -216,7 +219,7 @@ public:
 		string arg = string("I(") + short_name + ")";
 		int vt;
 
-		if (swill_getargs(arg.c_str(), &vt) && vt > 0)
+		if (swill_getargs(arg.c_str(), &vt) && vt >= min_v)
 			v = vt;
 	}
 	// Return the value
@@ -28,6 +28,15 @@
 #include "cpp.h"
 #include "debug.h"
 #include "error.h"
+#include "os.h"
+
+static string current_dir;		// Cached current directory; empty if unknown
+
+void
+current_dir_changed()
+{
+	current_dir.clear();
+}
 
 #ifdef WIN32
 #include <windows.h>
@@ -86,6 +95,17 @@ is_absolute_filename(const string &s)
 	return (s.length() > 0 && (s[0] == '/' || s[0] == '\\')) ||
 	    (s.length() > 3 && s[1] == ':' && (s[2] == '/' || s[2] == '\\'));
 }
+
+const string &
+get_current_dir()
+{
+	if (current_dir.empty()) {
+		char buff[4096];
+		DWORD n = GetCurrentDirectory(sizeof(buff), buff);
+		current_dir = (n > 0 && n < sizeof(buff)) ? buff : ".";
+	}
+	return current_dir;
+}
 #endif /* WIN32 */
 
 #if defined(unix) || defined(__unix__) || defined(__MACH__)
@@ -95,7 +115,7 @@ is_absolute_filename(const string &s)
 #include <unistd.h>
 #include <limits.h>
 
-char *
+const char *
 get_uniq_fname_string(const char *name)
 {
 	static char buff[128];
@@ -120,12 +140,10 @@ const char *
 get_full_path(const char *name)
 {
 	static char buff[PATH_MAX + NAME_MAX + 2];
-	char wd[PATH_MAX + NAME_MAX];
 
 	if (name[0] != '/') {
 		// Relative path
-		(void)getcwd(wd, sizeof(wd));
-		sprintf(buff, "%s/%s", wd, name);
+		snprintf(buff, sizeof(buff), "%s/%s", get_current_dir().c_str(), name);
 		return (buff);
 	} else
 		return (name);
@@ -137,5 +155,15 @@ is_absolute_filename(const string &s)
 {
 	return s.length() > 0 && s[0] == '/';
 }
+
+const string &
+get_current_dir()
+{
+	if (current_dir.empty()) {
+		char buff[PATH_MAX + NAME_MAX];
+		current_dir = getcwd(buff, sizeof(buff)) ? buff : ".";
+	}
+	return current_dir;
+}
 #endif /* unix */
 
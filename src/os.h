@@ -34,5 +34,9 @@ const char *get_uniq_fname_string(const char *pathname);
 const char *get_full_path(const char *pathname);
 // Return true if pathname is an absolute file path
 bool is_absolute_filename(const string &pathname);
+// Return the current directory; cached until current_dir_changed() is called
+const string &get_current_dir();
+// Called after changing the current directory
+void current_dir_changed();
 
 #endif // OS_
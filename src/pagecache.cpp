@@ -0,0 +1,101 @@
+/*
+ * (C) Copyright 2026 Diomidis Spinellis
+ *
+ * This file is part of CScout.
+ *
+ * CScout is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * CScout is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with CScout.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *
+ * For documentation read the corresponding .h file
+ *
+ */
+
+#include <cstdio>
+#include <functional>
+#include <list>
+#include <string>
+#include <unordered_map>
+#include <utility>
+
+#include "option.h"
+#include "pagecache.h"
+
+PageCache::PageList PageCache::pages;
+unordered_map <string, PageCache::PageList::iterator> PageCache::index;
+size_t PageCache::size;
+unsigned long PageCache::generation;
+
+void
+PageCache::invalidate()
+{
+	generation++;
+	shrink(0);
+}
+
+void
+PageCache::shrink(size_t max)
+{
+	while (size > max) {
+		size -= pages.back().first.length() + pages.back().second.length();
+		index.erase(pages.back().first);
+		pages.pop_back();
+	}
+}
+
+void
+PageCache::serve(FILE *of, const char *name, const char *query,
+    const function <void (FILE *)> &render)
+{
+	size_t max = (size_t)Option::page_cache_size->get() * 1024 * 1024;
+	if (max == 0) {
+		shrink(0);
+		render(of);
+		return;
+	}
+
+	string key(to_string(generation) + ' ' + name + '?' + (query ? query : ""));
+	unordered_map <string, PageList::iterator>::iterator i = index.find(key);
+	if (i != index.end()) {
+		// Move it to the front
+		pages.splice(pages.begin(), pages, i->second);
+		const string &page(i->second->second);
+		fwrite(page.data(), 1, page.length(), of);
+		return;
+	}
+
+	// Generate the page in a temporary file, and read it back
+	FILE *tmp = tmpfile();
+	if (tmp == NULL) {
+		render(of);
+		return;
+	}
+	render(tmp);
+	string page;
+	long len = ftell(tmp);
+	if (len > 0) {
+		page.resize(len);
+		rewind(tmp);
+		page.resize(fread(&page[0], 1, len, tmp));
+	}
+	fclose(tmp);
+	fwrite(page.data(), 1, page.length(), of);
+
+	size_t page_size = key.length() + page.length();
+	if (page_size > max)
+		return;
+	shrink(max - page_size);
+	pages.push_front(make_pair(key, page));
+	index[key] = pages.begin();
+	size += page_size;
+}
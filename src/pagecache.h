@@ -0,0 +1,64 @@
+/*
+ * (C) Copyright 2026 Diomidis Spinellis
+ *
+ * This file is part of CScout.
+ *
+ * CScout is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * CScout is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with CScout.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *
+ * A cache of generated web pages.
+ * Pages that are expensive to generate, such as query results,
+ * metrics, and graphs, are stored keyed by their URL and a generation
+ * number of the state on which they depend.  Operations that modify
+ * the state (refactorings, option and project changes, edits, saves)
+ * increment the generation, discarding the cached pages.
+ * The cache's size is bounded by the page_cache_size option;
+ * when it is exceeded the least recently used pages are discarded.
+ *
+ */
+
+#ifndef PAGECACHE_
+#define PAGECACHE_
+
+#include <cstdio>
+#include <functional>
+#include <list>
+#include <string>
+#include <unordered_map>
+#include <utility>
+
+using namespace std;
+
+class PageCache {
+private:
+	typedef list <pair <string, string> > PageList;	// Key and page
+	static PageList pages;		// Most recently used first
+	static unordered_map <string, PageList::iterator> index;
+	static size_t size;		// Size of the cached pages
+	static unsigned long generation;	// Generation of the cached state
+
+	// Discard the least recently used pages until size is at most max
+	static void shrink(size_t max);
+public:
+	// Called when the state the pages depend on changes
+	static void invalidate();
+	/*
+	 * Output to of the page called name with the specified query
+	 * string, generating it with render if it is not cached.
+	 */
+	static void serve(FILE *of, const char *name, const char *query,
+	    const function <void (FILE *)> &render);
+};
+
+#endif /* PAGECACHE_ */
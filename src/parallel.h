@@ -0,0 +1,74 @@
+/*
+ * (C) Copyright 2026 Diomidis Spinellis
+ *
+ * This file is part of CScout.
+ *
+ * CScout is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * CScout is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with CScout.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *
+ * Support for running independent work items on a pool of threads.
+ * The number of threads is set through the -j command-line option.
+ * Work items must only modify state that is private to them;
+ * merging their results into CScout's global data structures
+ * is the caller's responsibility, and must be done serially.
+ *
+ */
+
+#ifndef PARALLEL_
+#define PARALLEL_
+
+#include <atomic>
+#include <cstddef>
+#include <thread>
+#include <vector>
+
+using namespace std;
+
+class Parallel {
+private:
+	static int jobs;		// Number of threads to use
+public:
+	static void set_jobs(int n) { jobs = n > 0 ? n : 1; }
+	static int get_jobs() { return jobs; }
+	// Return true if work should be distributed among threads
+	static bool is_enabled() { return jobs > 1; }
+
+	/*
+	 * Call f(i) for every i in [0, n), distributing the calls
+	 * among the configured number of threads.
+	 * Return after all calls have completed.
+	 */
+	template <typename F>
+	static void for_each_index(size_t n, F f) {
+		if (jobs <= 1 || n <= 1) {
+			for (size_t i = 0; i < n; i++)
+				f(i);
+			return;
+		}
+		atomic <size_t> next(0);
+		auto worker = [&]() {
+			for (size_t i; (i = next++) < n; )
+				f(i);
+		};
+		size_t nthreads = (size_t)jobs < n ? jobs : n;
+		vector <thread> threads;
+		for (size_t t = 1; t < nthreads; t++)
+			threads.emplace_back(worker);
+		worker();
+		for (auto &t : threads)
+			t.join();
+	}
+};
+
+#endif /* PARALLEL_ */
@@ -63,6 +63,7 @@
 #include "filedetails.h"
 #include "os.h"
 #include "ctag.h"
+#include "profiler.h"
 #include "type.h"		// stab.h
 #include "stab.h"		// Block::enter()
 
@@ -628,19 +629,6 @@ Pdtoken::process_endif()
 	eat_to_eol();
 }
 
-// Return true if we can open a given file
-static bool
-can_open(const string& s)
-{
-	ifstream in;
-	in.open(s.c_str());
-	if (!in.fail()) {
-		in.close();
-		return (true);
-	} else
-		return (false);
-}
-
 /*
  * When next is true we start scanning the include path from the directory
  * following the one in which the current file was found (gcc extension).
@@ -714,7 +702,7 @@ Pdtoken::process_include(bool next)
 	}
 	// #include <foo.h> and #include "foo.h"
 	if (is_absolute_filename(f.get_val())) {
-		if (can_open(f.get_val())) {
+		if (IncludeCache::can_open(f.get_val())) {
 			if (!Pdtoken::shall_skip(Fileid(f.get_val())))
 				Fchar::push_input(f.get_val());
 			return;
@@ -734,25 +722,21 @@ Pdtoken::process_include(bool next)
 		 */
 		if (f.get_code() == ABSFNAME && !next) {
 			string fname(Fchar::get_dir() + "/" + f.get_val());
-			if (can_open(fname)) {
+			if (IncludeCache::can_open(fname)) {
 				if (!Pdtoken::shall_skip(Fileid(fname)))
 					Fchar::push_input(fname);
 				return;
 			}
 		}
-		vectorstring::iterator i;
-		i = include_path.begin();
-		if (next)
-			i += Filedetails::get_ipath_offset(Fchar::get_fileid()) + 1;
-		for (; i < include_path.end(); i++) {
-			string fname(*i + "/" + f.get_val());
-			if (DP()) cout << "Try open " << fname << "\n";
-			if (can_open(fname)) {
-				if (!Pdtoken::shall_skip(Fileid(fname)))
-					Fchar::push_input(fname);
-				Filedetails::set_ipath_offset(Fchar::get_fileid(), i - include_path.begin());
-				return;
-			}
+		int start = next ? Filedetails::get_ipath_offset(Fchar::get_fileid()) + 1 : 0;
+		int i = IncludeCache::search(include_path, start, f.get_val());
+		if (i != -1) {
+			string fname(include_path[i] + "/" + f.get_val());
+			if (DP()) cout << "Found " << fname << "\n";
+			if (!Pdtoken::shall_skip(Fileid(fname)))
+				Fchar::push_input(fname);
+			Filedetails::set_ipath_offset(Fchar::get_fileid(), i);
+			return;
 		}
 	}
 	/*
@@ -931,6 +915,7 @@ Pdtoken::process_define(bool is_immutable)
 		macros.insert(mapMacro::value_type(name, m));
 	else if (!mi->second.get_is_immutable())
 		mi->second = m;
+	ClashCheck::declare_macro(nametok);
 	if (is_function)
 		m.register_macro_body(macro_body_tokens);
 	if (DP()) cout << "Macro define " << m;
@@ -1158,6 +1143,7 @@ Pdtoken::process_pragma()
 			if (preprocessed_output_spec.exec(t.get_val().c_str(),
 						0, NULL, 0) != REG_NOMATCH)
 				preprocess_to_output(t.get_val());
+			HideSet::clear();
 		} else if (!processed_files_spec.isSet()
 		    || processed_files_spec.exec(t.get_val().c_str(),
 			    0, NULL, 0) != REG_NOMATCH) {
@@ -1165,14 +1151,20 @@ Pdtoken::process_pragma()
 			extern int parse_parse();
 			extern void garbage_collect(Fileid fi);
 
+			string unit_path(get_full_path(t.get_val().c_str()));
+			Profiler::Sample unit_start(Profiler::now());
 			Fchar::push_input(t.get_val());
 			Fchar::lock_stack();
 			Block::param_clear();
 			Block::set_cu_file_id(Fchar::get_fileid());
 			if (parse_parse() != 0)
 				exit(1);
+			Profiler::Sample gc_start(Profiler::now());
 			garbage_collect(Fileid(t.get_val()));
+			Profiler::record("gc", unit_path, gc_start);
+			HideSet::clear();
 			Fchar::unlock_stack();
+			Profiler::record("unit", unit_path, unit_start);
 		}
 	} else if (t.get_val() == "pushd") {
 		char buff[4096];
@@ -1202,6 +1194,7 @@ Pdtoken::process_pragma()
 		}
 		if (chdir(t.get_val().c_str()) != 0)
 			Error::error(E_FATAL, "chdir " + t.get_val() + ": " + string(strerror(errno)));
+		current_dir_changed();
 	} else if (t.get_val() == "popd") {
 		if (dirstack.empty()) {
 			/*
@@ -1219,6 +1212,7 @@ Pdtoken::process_pragma()
 			cout << "popd to " << dirstack.top().c_str() << endl;
 		if (chdir(dirstack.top().c_str()) != 0)
 			Error::error(E_FATAL, "popd: " + dirstack.top() + ": " + string(strerror(errno)));
+		current_dir_changed();
 		dirstack.pop();
 	} else if (t.get_val() == "clear_include") {
 		Pdtoken::clear_include();
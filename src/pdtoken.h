@@ -40,6 +40,8 @@ using namespace std;
 #include "macro.h"
 #include "fileid.h"
 #include "compiledre.h"
+#include "clashcheck.h"
+#include "inccache.h"
 
 class Pdtoken;
 
@@ -126,6 +128,7 @@ public:
 	static void macros_clear() {
 		macros.clear();
 		macro_body_tokens.clear();
+		ClashCheck::macro_scope();
 	}
 
 	// Return the number of defined macros
@@ -142,9 +145,9 @@ public:
 	// Add to the macros map an undefined macro
 	static void create_undefined_macro(const Ptoken &name);
 	// Add an element in the include path
-	static void add_include(const string& s) { include_path.push_back(s); };
+	static void add_include(const string& s) { include_path.push_back(s); IncludeCache::path_changed(); };
 	// Clear the include path
-	static void clear_include() { include_path.clear(); };
+	static void clear_include() { include_path.clear(); IncludeCache::path_changed(); };
 	// Called when we start processing a new file
 	// or resume an old one.  We assume that files end in line
 	// boundaries, even when they lack an explicit newline at their end
@@ -0,0 +1,168 @@
+/*
+ * (C) Copyright 2026 Diomidis Spinellis
+ *
+ * This file is part of CScout.
+ *
+ * CScout is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * CScout is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with CScout.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *
+ * For documentation read the corresponding .h file
+ *
+ */
+
+#include <chrono>
+#include <cstdlib>
+#include <ctime>
+#include <fstream>
+#include <iostream>
+#include <string>
+#include <vector>
+#if defined(unix) || defined(__unix__) || defined(__MACH__)
+#include <sys/types.h>
+#include <sys/time.h>
+#include <sys/resource.h>	// getrusage(2)
+#define HAVE_GETRUSAGE
+#endif
+
+#include "cpp.h"
+#include "error.h"
+#include "tokid.h"
+#include "eclass.h"
+#include "call.h"
+#include "macro.h"
+#include "pdtoken.h"
+#include "type.h"
+#include "profiler.h"
+
+bool Profiler::enabled;
+string Profiler::fname;
+vector <Profiler::Record> Profiler::records;
+string Profiler::phase_name;
+Profiler::Sample Profiler::phase_start;
+
+void
+Profiler::enable(const string &f)
+{
+	enabled = true;
+	fname = f;
+	atexit(save);
+}
+
+Profiler::Sample
+Profiler::now()
+{
+	Sample s;
+
+	if (!enabled)
+		return s;
+	s.wall = chrono::duration<double>(chrono::steady_clock::now().time_since_epoch()).count();
+#ifdef HAVE_GETRUSAGE
+	struct rusage ru;
+	getrusage(RUSAGE_SELF, &ru);
+	s.cpu = ru.ru_utime.tv_sec + ru.ru_utime.tv_usec * 1e-6 +
+	    ru.ru_stime.tv_sec + ru.ru_stime.tv_usec * 1e-6;
+#else
+	s.cpu = (double)clock() / CLOCKS_PER_SEC;
+#endif
+	return s;
+}
+
+void
+Profiler::record(const char *kind, const string &name, const Sample &start)
+{
+	if (!enabled)
+		return;
+	Sample end(now());
+	Record r;
+	r.kind = kind;
+	r.name = name;
+	r.wall = end.wall - start.wall;
+	r.cpu = end.cpu - start.cpu;
+	r.max_rss = 0;
+#ifdef HAVE_GETRUSAGE
+	struct rusage ru;
+	getrusage(RUSAGE_SELF, &ru);
+	r.max_rss = ru.ru_maxrss;
+#ifdef __MACH__
+	r.max_rss /= 1024;		// Reported in bytes
+#endif
+#endif
+	r.tokids = Tokid::map_size();
+	r.ecs = Eclass::get_count();
+	r.functions = Call::fsize();
+	r.macros = Pdtoken::macros_size();
+#ifdef NODE_USE_PROFILE
+	r.type_nodes = Type_node::get_count();
+#else
+	r.type_nodes = -1;
+#endif
+	records.push_back(r);
+}
+
+void
+Profiler::phase(const char *n)
+{
+	if (!enabled)
+		return;
+	if (!phase_name.empty())
+		record("phase", phase_name, phase_start);
+	phase_name = n ? n : "";
+	phase_start = now();
+}
+
+// Return s quoted as a CSV field
+static string
+csv_quote(const string &s)
+{
+	string r("\"");
+	for (string::const_iterator i = s.begin(); i != s.end(); i++) {
+		if (*i == '"')
+			r += '"';
+		r += *i;
+	}
+	return r + '"';
+}
+
+void
+Profiler::save()
+{
+	phase(NULL);
+	ofstream out(fname.c_str());
+	out << "kind,name,wall,cpu,max_rss_kb,tokids,ecs,functions,macros,type_nodes\n";
+	for (vector <Record>::const_iterator i = records.begin(); i != records.end(); i++) {
+		out << i->kind << ',' <<
+		    csv_quote(i->name) << ',' <<
+		    i->wall << ',' <<
+		    i->cpu << ',' <<
+		    i->max_rss << ',' <<
+		    i->tokids << ',' <<
+		    i->ecs << ',' <<
+		    i->functions << ',' <<
+		    i->macros << ',';
+		if (i->type_nodes >= 0)
+			out << i->type_nodes;
+		out << '\n';
+	}
+	out.close();
+	if (out.fail()) {
+		/*
+		 * @error
+		 * The profiling report specified with the -T option
+		 * could not be written.
+		 */
+		Error::error(E_ERR, fname + ": unable to save profiling report", false);
+		return;
+	}
+	cerr << "Profiling report saved in " << fname << endl;
+}
@@ -0,0 +1,80 @@
+/*
+ * (C) Copyright 2026 Diomidis Spinellis
+ *
+ * This file is part of CScout.
+ *
+ * CScout is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * CScout is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with CScout.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *
+ *
+ * Profiling of processing phases and compilation units (the -T option).
+ * For each phase (e.g. parsing or post-processing the files), and for
+ * each compilation unit and its garbage collection, a record is kept
+ * with the elapsed wall clock and CPU time, the process's peak
+ * resident set size, and the sizes of the main data structures at its
+ * end.  On exit the records are saved as a CSV file with a header line.
+ *
+ */
+
+#ifndef PROFILER_
+#define PROFILER_
+
+#include <string>
+#include <vector>
+
+using namespace std;
+
+class Profiler {
+public:
+	// A point in time
+	struct Sample {
+		double wall;		// Wall clock time (s)
+		double cpu;		// Process CPU time (s)
+		Sample() : wall(0), cpu(0) {}
+	};
+private:
+	// Resources used by a phase or unit
+	struct Record {
+		string kind;		// phase, unit, or gc
+		string name;		// Its name
+		double wall;		// Elapsed wall clock time (s)
+		double cpu;		// Elapsed CPU time (s)
+		long max_rss;		// Peak resident set size (KB)
+		size_t tokids;		// Tokid to EC mappings
+		size_t ecs;		// Equivalence classes
+		size_t functions;	// Functions and macros
+		size_t macros;		// Currently defined macros
+		int type_nodes;		// Type nodes (-1 if not counted)
+	};
+	static bool enabled;		// True if profiling is on
+	static string fname;		// The report's file name
+	static vector <Record> records;	// Collected records
+	static string phase_name;	// Current phase
+	static Sample phase_start;	// and its start
+
+	// Save the report; called on exit
+	static void save();
+public:
+	// Enable profiling, saving the report in file f
+	static void enable(const string &f);
+	static bool is_enabled() { return enabled; }
+	// Return the current time (zero when profiling is disabled)
+	static Sample now();
+	// Record the resources used by kind name since start
+	static void record(const char *kind, const string &name, const Sample &start);
+	// End the current phase (if any) and begin the one named n
+	static void phase(const char *n);
+};
+
+#endif /* PROFILER_ */
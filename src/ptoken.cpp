@@ -37,6 +37,7 @@
 #include "fileid.h"
 #include "tokid.h"
 #include "token.h"
+#include "hideset.h"
 #include "ptoken.h"
 #include "ctoken.h"
 
@@ -45,8 +46,9 @@ operator<<(ostream& o,const Ptoken &t)
 {
 	o << (Token)t;
 	o << "Value: [" << t.val << "] HS(";
-	for (HideSet::const_iterator i = t.hideset.begin(); i != t.hideset.end(); i++)
-		o << *i;
+	const HideSet::members_type &m(t.hideset.members());
+	for (HideSet::members_type::const_iterator i = m.begin(); i != m.end(); i++)
+		o << HideSet::get_token(*i);
 	o << ')' << endl;
 	return (o);
 }
@@ -36,12 +36,11 @@ using namespace std;
 #include "fileid.h"
 #include "tokid.h"
 #include "token.h"
+#include "hideset.h"
 #include "parse.tab.h"
 
 class Ctoken;
 
-typedef set <Token> HideSet;
-
 class Ptoken : public Token {
 private:
 	HideSet hideset;	// Hide set used for macro expansions
@@ -53,10 +52,9 @@ public:
 	// Construct it from a CToken
 	Ptoken(const Ctoken &t);
 	// Accessor methods
-	inline bool hideset_contains(const Ptoken &t) const { return (hideset.find(t) != hideset.end()); }
-	inline void hideset_insert(Token t) { hideset.insert(t); }
-	inline void hideset_insert(HideSet::const_iterator b, HideSet::const_iterator e) { hideset.insert(b, e); }
-	inline const HideSet& get_hideset() const { return (hideset); }
+	inline bool hideset_contains(HideSet::atom_type a) const { return hideset.contains(a); }
+	inline void hideset_insert(HideSet hs) { hideset = hideset.unite(hs); }
+	inline HideSet get_hideset() const { return (hideset); }
 	// Print it (for debugging)
 	friend ostream& operator<<(ostream& o,const Ptoken &t);
 	inline friend bool operator ==(const Ptoken& a, const Ptoken& b);
@@ -0,0 +1,142 @@
+/*
+ * (C) Copyright 2026 Diomidis Spinellis
+ *
+ * This file is part of CScout.
+ *
+ * CScout is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * CScout is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with CScout.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *
+ * For documentation read the corresponding .h file
+ *
+ */
+
+#include <algorithm>
+#include <iostream>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+#include "call.h"
+#include "reach.h"
+
+bool ReachIndex::enabled;
+bool ReachIndex::built;
+Reachability ReachIndex::calls;
+vector <Call *> ReachIndex::functions;
+unordered_map <Call *, unsigned> ReachIndex::function_ordinal;
+
+/*
+ * Tarjan's algorithm, without recursion, so that long call chains
+ * cannot overflow the stack.
+ * Components are numbered in reverse topological order: all components
+ * reachable from a component have a lower number, so a component's
+ * bitset can be computed from those of its successors as soon as the
+ * component is found.
+ */
+void
+Reachability::build(const vector <vector <unsigned> > &successors)
+{
+	const unsigned unvisited = (unsigned)-1;
+	size_t n = successors.size();
+	vector <unsigned> index(n, unvisited), lowlink(n);
+	vector <bool> on_stack(n, false);
+	vector <unsigned> stack;
+	// Nodes being explored and the position of their next successor
+	vector <pair <unsigned, size_t> > path;
+	unsigned counter = 0;
+
+	component.assign(n, 0);
+	members.clear();
+	for (unsigned root = 0; root < n; root++) {
+		if (index[root] != unvisited)
+			continue;
+		index[root] = lowlink[root] = counter++;
+		stack.push_back(root);
+		on_stack[root] = true;
+		path.push_back(make_pair(root, 0));
+		while (!path.empty()) {
+			unsigned v = path.back().first;
+			size_t &next = path.back().second;
+			if (next < successors[v].size()) {
+				unsigned w = successors[v][next++];
+				if (index[w] == unvisited) {
+					index[w] = lowlink[w] = counter++;
+					stack.push_back(w);
+					on_stack[w] = true;
+					path.push_back(make_pair(w, 0));
+				} else if (on_stack[w])
+					lowlink[v] = min(lowlink[v], index[w]);
+				continue;
+			}
+			path.pop_back();
+			if (!path.empty())
+				lowlink[path.back().first] = min(lowlink[path.back().first], lowlink[v]);
+			if (lowlink[v] != index[v])
+				continue;
+			// v is the root of a component
+			unsigned c = members.size();
+			members.push_back(vector <unsigned>());
+			unsigned w;
+			do {
+				w = stack.back();
+				stack.pop_back();
+				on_stack[w] = false;
+				component[w] = c;
+				members.back().push_back(w);
+			} while (w != v);
+		}
+	}
+
+	words = (members.size() + 63) / 64;
+	reach.assign(members.size() * words, 0);
+	for (unsigned c = 0; c < members.size(); c++) {
+		uint64_t *r = &reach[c * words];
+		// A component reaches itself only through a cycle
+		if (members[c].size() > 1)
+			r[c / 64] |= (uint64_t)1 << (c % 64);
+		for (vector <unsigned>::const_iterator v = members[c].begin(); v != members[c].end(); v++)
+			for (vector <unsigned>::const_iterator w = successors[*v].begin(); w != successors[*v].end(); w++) {
+				unsigned s = component[*w];
+				r[s / 64] |= (uint64_t)1 << (s % 64);
+				if (s == c)
+					continue;
+				const uint64_t *rs = &reach[s * words];
+				for (size_t i = 0; i < words; i++)
+					r[i] |= rs[i];
+			}
+	}
+}
+
+void
+ReachIndex::build()
+{
+	// The call graph
+	functions.clear();
+	function_ordinal.clear();
+	for (Call::const_fmap_iterator_type i = Call::fbegin(); i != Call::fend(); i++)
+		if (function_ordinal.insert(make_pair(i->second, (unsigned)functions.size())).second)
+			functions.push_back(i->second);
+	vector <vector <unsigned> > successors(functions.size());
+	for (unsigned n = 0; n < functions.size(); n++)
+		for (Call::const_fiterator_type i = functions[n]->call_begin(); i != functions[n]->call_end(); i++) {
+			unordered_map <Call *, unsigned>::const_iterator o = function_ordinal.find(*i);
+			if (o != function_ordinal.end())
+				successors[n].push_back(o->second);
+		}
+	calls.build(successors);
+
+	built = true;
+	cerr << "Reachability index: " << calls.size() << " functions in " <<
+	    calls.components() << " components" << endl;
+}
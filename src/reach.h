@@ -0,0 +1,121 @@
+/*
+ * (C) Copyright 2026 Diomidis Spinellis
+ *
+ * This file is part of CScout.
+ *
+ * CScout is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * CScout is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with CScout.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *
+ * Reachability index over the function call graph, optionally
+ * built (-x) before serving web pages.
+ * The graph is condensed into the directed acyclic graph of its
+ * strongly connected components, and for each component a bitset
+ * of the components reachable from it is stored.
+ * Listing all functions transitively called by or calling a function
+ * then becomes a lookup rather than a traversal of the graph.
+ *
+ * The bitsets take space quadratic to the number of components,
+ * which is why the index is not built by default.
+ *
+ */
+
+#ifndef REACH_
+#define REACH_
+
+#include <cstddef>
+#include <cstdint>
+#include <unordered_map>
+#include <vector>
+
+using namespace std;
+
+class Call;
+
+// Reachability between the nodes of a graph, identified by their ordinal
+class Reachability {
+private:
+	vector <unsigned> component;	// Component of each node
+	vector <vector <unsigned> > members;	// Nodes of each component
+	size_t words;			// Words of each component's bitset
+	vector <uint64_t> reach;	// Components reachable from each one
+
+	bool test(unsigned from, unsigned to) const {
+		return (reach[from * words + to / 64] >> (to % 64)) & 1;
+	}
+public:
+	Reachability() : words(0) {}
+	// Build the index of a graph, given each node's successors
+	void build(const vector <vector <unsigned> > &successors);
+	// Return the number of nodes and components
+	size_t size() const { return component.size(); }
+	size_t components() const { return members.size(); }
+	// Return true if node b can be reached from node a through one or more edges
+	bool reaches(unsigned a, unsigned b) const {
+		return test(component[a], component[b]);
+	}
+	// Call f(n) for every node n that can be reached from node a
+	template <typename F>
+	void for_each_descendant(unsigned a, F f) const {
+		const uint64_t *r = &reach[component[a] * words];
+		for (size_t w = 0; w < words; w++)
+			for (uint64_t b = r[w]; b; b &= b - 1) {
+				const vector <unsigned> &m = members[w * 64 + __builtin_ctzll(b)];
+				for (vector <unsigned>::const_iterator i = m.begin(); i != m.end(); i++)
+					f(*i);
+			}
+	}
+	// Call f(n) for every node n from which node b can be reached
+	template <typename F>
+	void for_each_ancestor(unsigned b, F f) const {
+		unsigned cb = component[b];
+		for (unsigned c = 0; c < members.size(); c++)
+			if (test(c, cb))
+				for (vector <unsigned>::const_iterator i = members[c].begin(); i != members[c].end(); i++)
+					f(*i);
+	}
+};
+
+class ReachIndex {
+private:
+	static bool enabled;		// True if the index is to be built
+	static bool built;		// True if the index has been built
+	static Reachability calls;	// Function calls
+	static vector <Call *> functions;	// Functions by ordinal
+	static unordered_map <Call *, unsigned> function_ordinal;
+public:
+	static void enable() { enabled = true; }
+	static bool is_enabled() { return enabled; }
+	// Return true if the index can be used for lookups
+	static bool is_available() { return built; }
+	// Build the index from the processed functions
+	static void build();
+
+	/*
+	 * Call f(c) for every function transitively called by f
+	 * (called is true) or calling f (called is false).
+	 */
+	template <typename F>
+	static void for_each_function(Call *c, bool called, F f) {
+		unordered_map <Call *, unsigned>::const_iterator i = function_ordinal.find(c);
+		if (i == function_ordinal.end())
+			return;
+		auto g = [&](unsigned n) { f(functions[n]); };
+		if (called)
+			calls.for_each_descendant(i->second, g);
+		else
+			calls.for_each_ancestor(i->second, g);
+	}
+};
+
+#endif /* REACH_ */
@@ -25,6 +25,7 @@
 # -TEST_CPP
 # -TEST_C
 # -TEST_OBFUSCATION
+# -TEST_MODES
 #
 # To run a single test set the corresponding environment variable e.g.
 # CFILES=c36-endlabel.c ./runtest.sh -TEST_C
@@ -108,20 +109,24 @@ end_test()
 	fi
 }
 
-# Test the analysis of a C project
-# runtest name directory csfile
-runtest_c()
+# Dump the analysis of a C project into test/nout/name
+# dump_c name directory srcpath csfile [db-spec [options]]
+dump_c()
 {
 	NAME=$1
 	DIR=$2
 	SRCPATH=$3
 	CSFILE=$4
-	start_test $DIR $NAME
+	SPEC=${5:-sqlite}
 	mkdir -p test/err/chunk
 (
 echo '.print "Loading database"'
-(cd $DIR ; $SRCPATH/$CSCOUT -s sqlite $CSFILE) 2>test/err/chunk/$NAME.cs
+(cd $DIR ; $SRCPATH/$CSCOUT $6 -s $SPEC $CSFILE) 2>test/err/chunk/$NAME.cs
+case $SPEC in
+*:db=*)	echo ".open '${SPEC#*:db=}'" ;;
+esac
 cat <<\EOF
+.mode list
 PRAGMA synchronous = OFF;
 PRAGMA journal_mode = OFF;
 PRAGMA locking_mode = EXCLUSIVE;
@@ -236,7 +241,68 @@ EOF
 ) |
 sqlite3 |
 sed -e '1,/^Running selections/d' >test/nout/$NAME
-	end_compare $DIR $NAME
+}
+
+# Test the analysis of a C project
+# runtest name directory srcpath csfile
+runtest_c()
+{
+	start_test $2 $1
+	dump_c "$@"
+	end_compare $2 $1
+}
+
+# Compare the analysis of awk using a database mode or options
+# with the one obtained through the default settings
+# runtest_mode name db-spec [options]
+runtest_mode()
+{
+	start_test ../example "$1"
+	dump_c awk.c-$1 ../example ../src awk.cs "$2" "$3"
+	mkdir -p test/err/diff
+	if diff test/nout/awk.c-default test/nout/awk.c-$1 >test/err/diff/awk.c-$1
+	then
+		end_test $1 1
+	else
+		end_test $1 0
+		show_error test/err/diff/awk.c-$1
+	fi
+}
+
+# Output the number of rows of each table in SQL INSERT statements or
+# PostgreSQL COPY blocks read from the standard input
+count_rows()
+{
+	awk '
+	/^INSERT INTO [A-Za-z]* VALUES/ { n[$3]++ }
+	/^\\\.$/ { table = "" }
+	table != "" { n[table]++ }
+	/^COPY [A-Za-z]* FROM STDIN;$/ { table = $2 }
+	END { for (t in n) print t, n[t] }' |
+	sort
+}
+
+# Output the sorted names of all the functions called by main, as listed
+# by the web interface of CScout serving the awk example
+# called_functions port [options]
+called_functions()
+{
+	(cd ../example ; exec ../src/$CSCOUT -p $1 $2 awk.cs) 2>test/err/modes/serve-$1 &
+	SERVER=$!
+	until grep -q 'ready to serve' test/err/modes/serve-$1
+	do
+		kill -0 $SERVER 2>/dev/null || return 1
+		sleep 1
+	done
+	URL=http://localhost:$1
+	MAIN=$(curl -s "$URL/api/funs?limit=100000" |
+	sed -n 's/.*"call": "\([^"]*\)", "name": "main".*/\1/p')
+	curl -s "$URL/funlist.html?f=$MAIN&n=D" |
+	awk -F'<li> ' '{ for (i = 2; i <= NF; i++) print $i }' |
+	sed -n 's/^<a href="fun.html?f=[^"]*">\([^<]*\)<\/a>.*/\1/p' |
+	sort -u
+	curl -s $URL/qexit.html >/dev/null
+	wait $SERVER
 }
 
 # Test the correct dumping of a file's contents into the SQL tables
@@ -350,6 +416,7 @@ set_test()
 	TEST_CPP=$1
 	TEST_C=$1
 	TEST_OBFUSCATION=$1
+	TEST_MODES=$1
 }
 
 #
@@ -449,6 +516,69 @@ then
 	runtest_c awk.c ../example ../src awk.cs
 fi
 
+# Database modes and options that must not affect the results
+if [ $TEST_MODES = 1 ]
+then
+	TEST_GROUP=modes
+	mkdir -p test/err/modes
+	dump_c awk.c-default ../example ../src awk.cs
+	runtest_mode jobs sqlite '-j 4'
+	runtest_mode multirow sqlite:multirow
+	runtest_mode insert sqlite:insert
+	runtest_mode csv sqlite:csv
+	rm -f ../example/*.csv
+	if $CSCOUT -Z 2>&1 | grep -q 'db=file'
+	then
+		rm -f test/err/modes/awk.db
+		runtest_mode db sqlite:db=$(pwd)/test/err/modes/awk.db
+	fi
+	runtest_mode hash-murmur3 sqlite '-H murmur3'
+	runtest_mode hash-md5 sqlite '-H md5'
+	runtest_mode profile sqlite "-T $(pwd)/test/err/modes/profile.csv"
+	start_test . "profile contents"
+	if grep -q . test/err/modes/profile.csv
+	then
+		end_test profile-contents 1
+	else
+		end_test profile-contents 0
+	fi
+
+	# COPY blocks cannot be loaded into SQLite; compare the row counts
+	start_test ../example copy
+	(cd ../example ; ../src/$CSCOUT -s postgres awk.cs) 2>test/err/modes/insert.err |
+	count_rows >test/err/modes/insert.rows
+	(cd ../example ; ../src/$CSCOUT -s postgres:copy awk.cs) 2>test/err/modes/copy.err |
+	count_rows >test/err/modes/copy.rows
+	if test -s test/err/modes/insert.rows &&
+	   diff test/err/modes/insert.rows test/err/modes/copy.rows >test/err/diff/awk.c-copy
+	then
+		end_test copy 1
+	else
+		end_test copy 0
+		show_error test/err/diff/awk.c-copy
+	fi
+
+	# The reachability index must list at least the functions found
+	# through the depth-limited traversal, but not the function itself
+	if command -v curl >/dev/null
+	then
+		start_test ../example reach
+		called_functions 8181 >test/err/modes/called 2>&1
+		called_functions 8182 -x >test/err/modes/called-x 2>&1
+		if grep -q 'Reachability index' test/err/modes/serve-8182 &&
+		   test -s test/err/modes/called &&
+		   ! grep -qx main test/err/modes/called-x &&
+		   comm -23 test/err/modes/called test/err/modes/called-x >test/err/diff/awk.c-reach &&
+		   ! test -s test/err/diff/awk.c-reach
+		then
+			end_test reach 1
+		else
+			end_test reach 0
+			show_error test/err/diff/awk.c-reach
+		fi
+	fi
+fi
+
 # Finish priming
 if [ "$PRIME" = "1" ]
 then
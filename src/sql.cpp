@@ -21,11 +21,27 @@
  *
  */
 
+#include <cerrno>
+#include <cstdio>
 #include <cstring>
 #include <iostream>
+#include <fstream>
+#include <map>
+#include <set>
+#include <string>
+#include <vector>
+#if defined(unix) || defined(__unix__) || defined(__MACH__)
+#include <unistd.h>		// getcwd(3)
+#else
+#include <direct.h>		// getcwd(3)
+#endif
 
 #include "cpp.h"
+#include "error.h"
 #include "sql.h"
+#ifdef SQLITE_WRITER
+#include "sqlitewriter.h"
+#endif
 
 // An instance of the database interface
 Sql *Sql::instance;
@@ -34,7 +50,7 @@ Sql *Sql::instance;
 const char *
 Sql::escape(char c)
 {
-	static char str[2];
+	static thread_local char str[2];
 
 	switch (c) {
 	case '\'': return "''";
@@ -47,7 +63,7 @@ Sql::escape(char c)
 const char *
 Hsqldb::escape(char c)
 {
-	static char str[2];
+	static thread_local char str[2];
 
 	switch (c) {
 	case '\'': return "''";
@@ -62,7 +78,7 @@ Hsqldb::escape(char c)
 const char *
 Sqlite::escape(char c)
 {
-	static char str[2];
+	static thread_local char str[2];
 
 	switch (c) {
 	case '\'': return "''";
@@ -85,24 +101,384 @@ Sql::escape(string s)
 }
 
 bool
-Sql::setEngine(const char *dbengine)
+Sql::setEngine(const char *spec)
 {
-	if (strcmp(dbengine, "mysql") == 0)
+	string dbengine(spec);
+	string mode;
+	string::size_type colon = dbengine.find(':');
+	if (colon != string::npos) {
+		mode = dbengine.substr(colon + 1);
+		dbengine.erase(colon);
+	}
+
+	if (dbengine == "mysql")
 		instance = new Mysql();
-	else if (strcmp(dbengine, "hsqldb") == 0)
+	else if (dbengine == "hsqldb")
 		instance = new Hsqldb();
-	else if (strcmp(dbengine, "postgres") == 0)
+	else if (dbengine == "postgres")
 		instance = new Postgres();
-	else if (strcmp(dbengine, "sqlite") == 0)
+	else if (dbengine == "sqlite")
 		instance = new Sqlite();
 	else {
 		cerr << "Unknown database engine " << dbengine << "\n";
 		cerr << "Supported database engine types are: hsqldb mysql postgres sqlite\n";
 		return false;
 	}
+
+	if (mode.empty() || mode == "insert")
+		instance->mode = m_insert;
+	else if (mode == "multirow")
+		instance->mode = m_multirow;
+	else if (mode == "copy" && dbengine == "postgres")
+		instance->mode = m_copy;
+	else if (mode == "csv" && dbengine != "hsqldb") {
+		char buff[4096];
+		if (getcwd(buff, sizeof(buff)) == NULL) {
+			perror("getcwd");
+			return false;
+		}
+		instance->mode = m_csv;
+		instance->csv_dir = buff;
+	} else if (mode.compare(0, 3, "db=") == 0 && dbengine == "sqlite") {
+#ifdef SQLITE_WRITER
+		instance->mode = m_direct;
+		instance->writer = new SqliteWriter(mode.substr(3));
+#else
+		cerr << "This version of CScout does not support writing directly into SQLite databases\n";
+		cerr << "Rebuild it with make SQLITE=1\n";
+		return false;
+#endif
+	} else {
+		cerr << "Unknown output mode " << mode << " for database engine " << dbengine << "\n";
+		cerr << "Supported output modes are: insert multirow (and csv for mysql, postgres, sqlite; copy for postgres; db=file for sqlite)\n";
+		return false;
+	}
 	return true;
 }
 
+// Append to a row being written directly the tag t and n bytes of value p
+static void
+add_direct(string &row, SqlWriter::e_tag t, const void *p, size_t n)
+{
+	row += (char)t;
+	row.append((const char *)p, n);
+}
+
+Sql::Table &
+Sql::get_table(const char *name)
+{
+	map <string, unsigned>::const_iterator i = table_index.find(name);
+	if (i != table_index.end())
+		return tables[i->second];
+	table_index[name] = tables.size();
+	tables.push_back(Table(name));
+	return tables.back();
+}
+
+void
+Sql::add_value(string &row, const string &s)
+{
+	if (mode == m_direct) {
+		unsigned len = s.length();
+		add_direct(row, SqlWriter::t_text, &len, sizeof(len));
+		row += s;
+		return;
+	}
+	if (!row.empty())
+		row += mode == m_copy ? '\t' : ',';
+	switch (mode) {
+	case m_insert:
+	case m_multirow:
+		row += '\'';
+		for (string::const_iterator i = s.begin(); i != s.end(); i++)
+			row += escape(*i);
+		row += '\'';
+		break;
+	case m_copy:
+		// PostgreSQL text format
+		for (string::const_iterator i = s.begin(); i != s.end(); i++)
+			switch (*i) {
+			case '\\': row += "\\\\"; break;
+			case '\n': row += "\\n"; break;
+			case '\r': row += "\\r"; break;
+			case '\t': row += "\\t"; break;
+			default: row += *i; break;
+			}
+		break;
+	case m_direct:
+		break;
+	case m_csv:
+		// RFC 4180
+		row += '"';
+		for (string::const_iterator i = s.begin(); i != s.end(); i++) {
+			if (*i == '"')
+				row += '"';
+			row += *i;
+		}
+		row += '"';
+		break;
+	}
+}
+
+void
+Sql::add_value(string &row, bool v)
+{
+	if (mode == m_direct)
+		add_value(row, (long long)v);
+	else if (mode == m_csv)
+		add_number(row, v ? "1" : "0");
+	else
+		add_number(row, boolval(v));
+}
+
+void
+Sql::add_value(string &row, long long v)
+{
+	if (mode == m_direct)
+		add_direct(row, SqlWriter::t_integer, &v, sizeof(v));
+	else
+		add_number(row, to_string(v));
+}
+
+void
+Sql::add_value(string &row, double v)
+{
+	if (mode == m_direct) {
+		add_direct(row, SqlWriter::t_real, &v, sizeof(v));
+		return;
+	}
+	// Same as the default ostream formatting
+	char buff[64];
+	snprintf(buff, sizeof(buff), "%g", v);
+	add_number(row, buff);
+}
+
+void
+Sql::add_number(string &row, const string &n)
+{
+	if (!row.empty())
+		row += mode == m_copy ? '\t' : ',';
+	row += n;
+}
+
+void
+Sql::add_null(string &row)
+{
+	switch (mode) {
+	case m_insert:
+	case m_multirow:
+		add_number(row, "NULL");
+		break;
+	case m_copy:
+		add_number(row, "\\N");
+		break;
+	case m_csv:
+		add_number(row, csv_null());
+		break;
+	case m_direct:
+		add_direct(row, SqlWriter::t_null, NULL, 0);
+		break;
+	}
+}
+
+void
+Sql::add_row(ostream &of, const char *table, const string &row)
+{
+	switch (mode) {
+	case m_insert:
+		of << "INSERT INTO " << table << " VALUES(" << row << ");\n";
+		return;
+	case m_direct:
+		writer->add_row(table, row);
+		return;
+	case m_csv:
+		{
+			Table &t(get_table(table));
+			if (!t.csv) {
+				string path(csv_dir + "/" + table + ".csv");
+				t.csv = new ofstream(path.c_str(), ios::binary);
+				if (t.csv->fail())
+					Error::error(E_FATAL, path + ": " + strerror(errno), false);
+			}
+			*t.csv << row << '\n';
+			if (*csv_null())
+				note_csv_nulls(t, row);
+		}
+		return;
+	case m_multirow:
+		{
+			Table &t(get_table(table));
+			t.rows += t.nrows ? ",\n(" : "(";
+			t.rows += row;
+			t.rows += ')';
+			t.nrows++;
+			// Keep statements within the servers' size limits
+			if (++pending >= 500)
+				flush(of);
+		}
+		return;
+	case m_copy:
+		{
+			Table &t(get_table(table));
+			t.rows += row;
+			t.rows += '\n';
+			t.nrows++;
+			if (++pending >= 10000)
+				flush(of);
+		}
+		return;
+	}
+}
+
+/*
+ * Output the rows of all tables.
+ * A table's rows can refer to rows of the tables that first
+ * appeared before it, so tables are output in that order.
+ */
+void
+Sql::flush(ostream &of)
+{
+	for (vector <Table>::iterator t = tables.begin(); t != tables.end(); t++) {
+		if (t->nrows == 0)
+			continue;
+		if (mode == m_multirow)
+			of << "INSERT INTO " << t->name << " VALUES\n" << t->rows << ";\n";
+		else
+			of << "COPY " << t->name << " FROM STDIN;\n" << t->rows << "\\.\n";
+		t->rows.clear();
+		t->nrows = 0;
+	}
+	pending = 0;
+}
+
+void
+Sql::begin_data(ostream &of, const string &schema)
+{
+	if (mode == m_direct) {
+		writer->execute(begin_commands());
+		writer->execute(schema);
+		writer->execute(begin_transaction());
+		return;
+	}
+	of << begin_commands() << schema;
+	if (mode == m_multirow || mode == m_copy)
+		of << begin_transaction();
+}
+
+void
+Sql::end_data(ostream &of, const string &indexes)
+{
+	switch (mode) {
+	case m_insert:
+		of << end_commands();
+		return;
+	case m_direct:
+		writer->execute("COMMIT;\n");
+		// Building the indexes after the load is faster than updating them
+		writer->execute(indexes);
+		writer->close();
+		delete writer;
+		writer = NULL;
+		return;
+	case m_multirow:
+	case m_copy:
+		flush(of);
+		of << "COMMIT;\n";
+		break;
+	case m_csv:
+		for (vector <Table>::iterator t = tables.begin(); t != tables.end(); t++) {
+			t->csv->close();
+			if (t->csv->fail())
+				Error::error(E_FATAL, csv_dir + "/" + t->name + ".csv: write failed", false);
+			delete t->csv;
+			t->csv = NULL;
+			of << load_csv(t->name, csv_dir + "/" + t->name + ".csv",
+			    t->ncolumns, t->null_columns);
+		}
+		break;
+	}
+	of << indexes << end_commands();
+}
+
+void
+Sql::note_csv_nulls(Table &t, const string &row)
+{
+	const string null(csv_null());
+
+	if (row.find(null) == string::npos)
+		return;
+	unsigned column = 0;
+	for (string::size_type i = 0; ; column++) {
+		string::size_type end;
+		if (i < row.length() && row[i] == '"') {
+			// Quoted value; a doubled quote stands for a quote
+			for (end = i + 1; end < row.length(); end++)
+				if (row[end] == '"' && (++end >= row.length() || row[end] != '"'))
+					break;
+		} else {
+			end = row.find(',', i);
+			if (end == string::npos)
+				end = row.length();
+			if (row.compare(i, end - i, null) == 0)
+				t.null_columns.insert(column);
+		}
+		if (end >= row.length())
+			break;
+		i = end + 1;
+	}
+	t.ncolumns = column + 1;
+}
+
+string
+Sql::load_csv(const string &table, const string &path,
+    unsigned ncolumns, const set <unsigned> &null_columns)
+{
+	return "-- Load " + path + " into table " + table + "\n";
+}
+
+string
+Mysql::load_csv(const string &table, const string &path,
+    unsigned ncolumns, const set <unsigned> &null_columns)
+{
+	return "LOAD DATA LOCAL INFILE '" + escape(path) + "' INTO TABLE " + table +
+	    " FIELDS TERMINATED BY ',' OPTIONALLY ENCLOSED BY '\"' ESCAPED BY '';\n";
+}
+
+string
+Postgres::load_csv(const string &table, const string &path,
+    unsigned ncolumns, const set <unsigned> &null_columns)
+{
+	return "\\copy " + table + " FROM '" + escape(path) + "' WITH (FORMAT csv)\n";
+}
+
+/*
+ * These are commands of the sqlite3 command-line shell.
+ * Files with NULL markers are imported into a temporary table,
+ * from which the NULL values are restored.
+ */
+string
+Sqlite::load_csv(const string &table, const string &path,
+    unsigned ncolumns, const set <unsigned> &null_columns)
+{
+	if (null_columns.empty())
+		return ".mode csv\n.import '" + path + "' " + table + "\n";
+
+	string columns, values;
+	for (unsigned i = 0; i < ncolumns; i++) {
+		string c("c" + to_string(i));
+		columns += (i ? ", " : "") + c;
+		values += i ? ", " : "";
+		if (null_columns.count(i))
+			values += "NULLIF(" + c + ", '" + csv_null() + "')";
+		else
+			values += c;
+	}
+	return "CREATE TEMP TABLE csv_import(" + columns + ");\n"
+	    ".mode csv\n.import '" + path + "' csv_import\n"
+	    "INSERT INTO " + table + " SELECT " + values + " FROM csv_import;\n"
+	    "DROP TABLE csv_import;\n";
+}
+
 /*
  * Implement very fast database inserts at the risk of
  * possible data corruption in case of a crash.
@@ -25,13 +25,83 @@
 #ifndef SQL_
 #define SQL_
 
+#include <fstream>
+#include <map>
+#include <ostream>
+#include <set>
+#include <string>
+#include <utility>
+#include <vector>
+
+using namespace std;
+
+/*
+ * Interface for writing table rows directly into a database,
+ * rather than outputting SQL commands.
+ * The rows passed to it are sequences of values, each consisting of
+ * a tag byte followed by the value in native representation:
+ * a long long, a double, or an unsigned length followed by the text.
+ */
+class SqlWriter {
+public:
+	enum e_tag { t_text, t_integer, t_real, t_null };
+	virtual ~SqlWriter() {}
+	// Execute the specified SQL commands
+	virtual void execute(const string &commands) = 0;
+	// Insert into the specified table a row of encoded values
+	virtual void add_row(const char *table, const string &row) = 0;
+	// Close the database
+	virtual void close() = 0;
+};
+
 class Sql {
+public:
+	// How table rows are output
+	enum e_mode {
+		m_insert,	// An INSERT statement for each row
+		m_multirow,	// Multi-row INSERT statements in a transaction
+		m_copy,		// PostgreSQL COPY FROM STDIN blocks
+		m_csv,		// Per-table CSV files and commands to load them
+		m_direct,	// Rows written directly into a database
+	};
+private:
 	// Instance of current engine
 	static Sql *instance;
+
+	// Rows of a table that are waiting to be output
+	struct Table {
+		string name;		// Table name
+		string rows;		// Formatted rows
+		unsigned nrows;		// Their number
+		ofstream *csv;		// CSV file (m_csv)
+		unsigned ncolumns;	// Number of columns (m_csv, if NULLs exist)
+		set <unsigned> null_columns;	// Columns with NULL values (m_csv)
+		Table(const string &n) : name(n), nrows(0), csv(NULL), ncolumns(0) {}
+	};
+	e_mode mode;			// Output mode
+	string csv_dir;			// Directory for the CSV files
+	SqlWriter *writer;		// Database writer (m_direct)
+	// Tables in order of first appearance, which satisfies
+	// foreign key constraints
+	vector <Table> tables;
+	map <string, unsigned> table_index;	// Position of each table
+	unsigned pending;		// Number of rows waiting to be output
+
+	// Return the table with the specified name
+	Table &get_table(const char *name);
+	// Note the columns of the CSV row that hold the csv_null() marker
+	void note_csv_nulls(Table &t, const string &row);
+	// Output all pending rows
+	void flush(ostream &of);
 public:
+	Sql() : mode(m_insert), writer(NULL), pending(0) {}
 	virtual ~Sql() {}
-	// Set the database to the specified engine
-	// Return true if OK
+	/*
+	 * Set the database to the specified engine, optionally followed
+	 * by a colon and an output mode: insert, multirow, copy, csv,
+	 * or (for sqlite) db=file.
+	 * Return true if OK
+	 */
 	static bool setEngine(const char *dbengine);
 	static Sql *getInterface() { return instance; }
 	virtual const char * begin_commands() { return ""; };
@@ -44,6 +114,95 @@ public:
 	virtual const char *booltype() { return "BOOLEAN"; }
 	virtual const char *varchar() { return "CHARACTER VARYING"; }
 	virtual const char *boolval(bool v);
+	virtual const char *begin_transaction() { return "START TRANSACTION;\n"; }
+	/*
+	 * Command to load the specified CSV file into a table.
+	 * Of its ncolumns, the null_columns (counting from 0) contain
+	 * NULL values.  The number of columns is only set if there are such.
+	 * Only engines that accept the csv mode override it.
+	 */
+	virtual string load_csv(const string &table, const string &path,
+	    unsigned ncolumns, const set <unsigned> &null_columns);
+	// Representation of NULL in CSV files
+	virtual const char *csv_null() { return ""; }
+
+	/*
+	 * Called before and after outputting table rows.
+	 * The first creates the specified schema; the second the specified
+	 * indexes, which are only output in the bulk-loading modes.
+	 */
+	void begin_data(ostream &of, const string &schema);
+	void end_data(ostream &of, const string &indexes);
+
+	/*
+	 * Append to row a column value formatted for the output mode.
+	 * These only modify row, and can thus be called concurrently.
+	 */
+	void add_value(string &row, const string &s);
+	void add_value(string &row, bool v);
+	void add_value(string &row, long long v);
+	void add_value(string &row, double v);
+	void add_number(string &row, const string &n);
+	void add_null(string &row);
+	// Output (or queue for output) a row of formatted values
+	void add_row(ostream &of, const char *table, const string &row);
+};
+
+/*
+ * Formatted table rows kept for output at a later point.
+ * Separate threads can format rows into their own buffers,
+ * which are then output serially.
+ */
+class SqlRowBuffer {
+private:
+	vector <pair <const char *, string> > rows;	// Tables and rows
+public:
+	void add(const char *table, const string &row) {
+		rows.push_back(make_pair(table, row));
+	}
+	size_t size() const { return rows.size(); }
+	// Output the rows in the range [begin, end)
+	void output(Sql *db, ostream &of, size_t begin, size_t end) const {
+		for (size_t i = begin; i < end; i++)
+			db->add_row(of, rows[i].first, rows[i].second);
+	}
+};
+
+/*
+ * A table row being output.
+ * Use it as a temporary, streaming into it the row's values; the
+ * row is output at the end of the full expression.  For example:
+ * SqlRow(db, of, "FILES") << fid.get_id() << fid.get_path() << ro;
+ * Rows constructed with a buffer are added to it, rather than output.
+ */
+class SqlRow {
+private:
+	Sql *db;
+	ostream *of;
+	SqlRowBuffer *buffer;
+	const char *table;
+	string row;		// The formatted values
+	SqlRow(const SqlRow &);
+	SqlRow &operator=(const SqlRow &);
+public:
+	SqlRow(Sql *d, ostream &o, const char *t) : db(d), of(&o), buffer(NULL), table(t) {}
+	SqlRow(Sql *d, SqlRowBuffer &b, const char *t) : db(d), of(NULL), buffer(&b), table(t) {}
+	~SqlRow() {
+		if (buffer)
+			buffer->add(table, row);
+		else
+			db->add_row(*of, table, row);
+	}
+	SqlRow &operator<<(const string &s) { db->add_value(row, s); return *this; }
+	SqlRow &operator<<(const char *s) { db->add_value(row, string(s)); return *this; }
+	SqlRow &operator<<(bool v) { db->add_value(row, v); return *this; }
+	SqlRow &operator<<(int v) { db->add_value(row, (long long)v); return *this; }
+	SqlRow &operator<<(unsigned v) { db->add_value(row, (long long)v); return *this; }
+	SqlRow &operator<<(long v) { db->add_value(row, (long long)v); return *this; }
+	SqlRow &operator<<(unsigned long v) { db->add_value(row, (long long)v); return *this; }
+	SqlRow &operator<<(double v) { db->add_value(row, v); return *this; }
+	// Add a NULL value
+	SqlRow &null() { db->add_null(row); return *this; }
 };
 
 class Mysql: public Sql {
@@ -54,6 +213,9 @@ public:
 	const char *booltype() { return "bool"; }
 	const char *varchar() { return "TEXT"; }
 	const char *boolval(bool v);
+	string load_csv(const string &table, const string &path,
+	    unsigned ncolumns, const set <unsigned> &null_columns);
+	const char *csv_null() { return "NULL"; }
 };
 
 class Hsqldb: public Sql {
@@ -64,12 +226,19 @@ public:
 
 class Postgres: public Sql {
 public:
+	string load_csv(const string &table, const string &path,
+	    unsigned ncolumns, const set <unsigned> &null_columns);
 };
 
 class Sqlite: public Sql {
 public:
 	const char *begin_commands();
 	const char * escape(char c);
+	const char *begin_transaction() { return "BEGIN TRANSACTION;\n"; }
+	string load_csv(const string &table, const string &path,
+	    unsigned ncolumns, const set <unsigned> &null_columns);
+	// The sqlite3 shell imports empty fields as empty strings
+	const char *csv_null() { return "\\N"; }
 };
 
 
@@ -0,0 +1,184 @@
+/*
+ * (C) Copyright 2026 Diomidis Spinellis
+ *
+ * This file is part of CScout.
+ *
+ * CScout is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * CScout is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with CScout.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *
+ * For documentation read the corresponding .h file
+ *
+ */
+
+#include <cerrno>
+#include <cstdio>
+#include <cstring>
+#include <map>
+#include <string>
+
+#include <sqlite3.h>
+
+#include "cpp.h"
+#include "error.h"
+#include "sql.h"
+#include "sqlitewriter.h"
+
+SqliteWriter::SqliteWriter(const string &p) :
+	path(p), db(NULL), last_table(NULL), last_statement(NULL)
+{
+	if (remove(path.c_str()) != 0 && errno != ENOENT)
+		Error::error(E_FATAL, path + ": " + strerror(errno), false);
+	if (sqlite3_open(path.c_str(), &db) != SQLITE_OK)
+		fatal("unable to create database");
+}
+
+void
+SqliteWriter::fatal(const string &what)
+{
+	/*
+	 * @error
+	 * An error occurred while writing the SQLite database specified
+	 * with the -s sqlite:db=file option.
+	 * The message reported by SQLite follows.
+	 */
+	Error::error(E_FATAL, path + ": " + what + ": " +
+	    (db ? sqlite3_errmsg(db) : "out of memory"), false);
+}
+
+void
+SqliteWriter::execute(const string &commands)
+{
+	char *msg;
+
+	if (sqlite3_exec(db, commands.c_str(), NULL, NULL, &msg) != SQLITE_OK) {
+		string err(msg ? msg : "unknown error");
+		sqlite3_free(msg);
+		fatal("command execution failed: " + err);
+	}
+}
+
+// Return the number of values in an encoded row
+static int
+count_values(const string &row)
+{
+	int n = 0;
+	for (const char *p = row.data(), *end = p + row.size(); p < end; n++)
+		switch (*p++) {
+		case SqlWriter::t_text:
+			{
+				unsigned len;
+				memcpy(&len, p, sizeof(len));
+				p += sizeof(len) + len;
+			}
+			break;
+		case SqlWriter::t_integer:
+			p += sizeof(long long);
+			break;
+		case SqlWriter::t_real:
+			p += sizeof(double);
+			break;
+		case SqlWriter::t_null:
+			break;
+		default:
+			csassert(0);
+		}
+	return n;
+}
+
+sqlite3_stmt *
+SqliteWriter::get_statement(const char *table, const string &row)
+{
+	// Rows of the same table typically follow each other
+	if (last_table && strcmp(last_table, table) == 0)
+		return last_statement;
+
+	sqlite3_stmt *&stmt(statements[table]);
+	if (!stmt) {
+		string sql("INSERT INTO ");
+		sql += table;
+		sql += " VALUES(";
+		for (int i = 0, n = count_values(row); i < n; i++)
+			sql += i ? ",?" : "?";
+		sql += ")";
+		if (sqlite3_prepare_v2(db, sql.c_str(), -1, &stmt, NULL) != SQLITE_OK)
+			fatal(sql);
+	}
+	last_table = table;
+	last_statement = stmt;
+	return stmt;
+}
+
+void
+SqliteWriter::add_row(const char *table, const string &row)
+{
+	sqlite3_stmt *stmt = get_statement(table, row);
+	int column = 0;
+	for (const char *p = row.data(), *end = p + row.size(); p < end; ) {
+		int r = SQLITE_OK;
+		column++;
+		switch (*p++) {
+		case t_text:
+			{
+				unsigned len;
+				memcpy(&len, p, sizeof(len));
+				p += sizeof(len);
+				r = sqlite3_bind_text(stmt, column, p, len, SQLITE_STATIC);
+				p += len;
+			}
+			break;
+		case t_integer:
+			{
+				long long v;
+				memcpy(&v, p, sizeof(v));
+				p += sizeof(v);
+				r = sqlite3_bind_int64(stmt, column, v);
+			}
+			break;
+		case t_real:
+			{
+				double v;
+				memcpy(&v, p, sizeof(v));
+				p += sizeof(v);
+				r = sqlite3_bind_double(stmt, column, v);
+			}
+			break;
+		case t_null:
+			r = sqlite3_bind_null(stmt, column);
+			break;
+		default:
+			csassert(0);
+		}
+		if (r != SQLITE_OK)
+			fatal(string("binding a value of table ") + table);
+	}
+	csassert(column == sqlite3_bind_parameter_count(stmt));
+	if (sqlite3_step(stmt) != SQLITE_DONE)
+		fatal(string("inserting into table ") + table);
+	sqlite3_reset(stmt);
+}
+
+void
+SqliteWriter::close()
+{
+	if (!db)
+		return;
+	for (map <string, sqlite3_stmt *>::iterator i = statements.begin(); i != statements.end(); i++)
+		sqlite3_finalize(i->second);
+	statements.clear();
+	last_table = NULL;
+	last_statement = NULL;
+	if (sqlite3_close(db) != SQLITE_OK)
+		fatal("unable to close database");
+	db = NULL;
+}
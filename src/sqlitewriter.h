@@ -0,0 +1,63 @@
+/*
+ * (C) Copyright 2026 Diomidis Spinellis
+ *
+ * This file is part of CScout.
+ *
+ * CScout is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * CScout is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with CScout.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *
+ * Direct writing of table rows into an SQLite database
+ * (the -s sqlite:db=file option).
+ * Rows are inserted through a prepared statement for each table,
+ * with their values bound as parameters, thus avoiding the
+ * generation and parsing of SQL text.
+ *
+ */
+
+#ifndef SQLITEWRITER_
+#define SQLITEWRITER_
+
+#include <map>
+#include <string>
+
+using namespace std;
+
+#include <sqlite3.h>
+
+#include "sql.h"
+
+class SqliteWriter : public SqlWriter {
+private:
+	string path;			// Database file
+	sqlite3 *db;			// Database connection
+	// Insert statements indexed by table
+	map <string, sqlite3_stmt *> statements;
+	// The most recently used statement and its table
+	const char *last_table;
+	sqlite3_stmt *last_statement;
+
+	// Return the insert statement for the specified table and row
+	sqlite3_stmt *get_statement(const char *table, const string &row);
+	// Terminate processing with an error message about the database
+	void fatal(const string &what);
+public:
+	// Create the database in the specified file, replacing any existing one
+	SqliteWriter(const string &path);
+	~SqliteWriter() { close(); }
+	void execute(const string &commands);
+	void add_row(const char *table, const string &row);
+	void close();
+};
+
+#endif /* SQLITEWRITER_ */
@@ -0,0 +1,115 @@
+/*
+ * (C) Copyright 2026 Diomidis Spinellis
+ *
+ * This file is part of CScout.
+ *
+ * CScout is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * CScout is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with CScout.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *
+ * For documentation read the corresponding .h file
+ *
+ */
+
+#include <list>
+#include <map>
+#include <memory>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "cpp.h"
+#include "fileid.h"
+#include "tokid.h"
+#include "eclass.h"
+#include "call.h"
+#include "filedetails.h"
+#include "fileview.h"
+#include "srcspans.h"
+
+SourceSpans::FileList SourceSpans::files;
+map <Fileid, SourceSpans::FileList::iterator> SourceSpans::index;
+size_t SourceSpans::size;
+const size_t SourceSpans::max_size;
+
+size_t
+SourceSpans::size_of(const Contents &c)
+{
+	return c.text.length() +
+	    c.identifiers.size() * sizeof(c.identifiers[0]) +
+	    c.funs.size() * sizeof(c.funs[0]);
+}
+
+void
+SourceSpans::shrink(size_t max)
+{
+	while (size > max) {
+		size -= size_of(files.back().second);
+		index.erase(files.back().first);
+		files.pop_back();
+	}
+}
+
+void
+SourceSpans::invalidate(Fileid fi)
+{
+	map <Fileid, FileList::iterator>::iterator i = index.find(fi);
+	if (i == index.end())
+		return;
+	size -= size_of(i->second->second);
+	files.erase(i->second);
+	index.erase(i);
+}
+
+const SourceSpans::Contents *
+SourceSpans::get(Fileid fi)
+{
+	map <Fileid, FileList::iterator>::iterator f = index.find(fi);
+	if (f != index.end()) {
+		// Move it to the front
+		files.splice(files.begin(), files, f->second);
+		return &f->second->second;
+	}
+
+	Contents c;
+	if (Filedetails::is_hand_edited(fi))
+		c.text = Filedetails::get_original_contents(fi);
+	else {
+		// Copy the bytes, for the file may later be edited
+		shared_ptr <const FileView> view(FileView::get(fi));
+		if (view->fail())
+			return NULL;
+		c.text.assign(view->data(), view->size());
+	}
+
+	// An identifier's characters cannot start another identifier
+	vector <pair <cs_offset_t, Eclass *> > ecs(Tokid::file_ecs(fi));
+	cs_offset_t end = 0;
+	for (vector <pair <cs_offset_t, Eclass *> >::const_iterator i = ecs.begin(); i != ecs.end(); i++)
+		if (i->first >= end && i->second->is_identifier()) {
+			c.identifiers.push_back(*i);
+			end = i->first + i->second->get_len();
+		}
+
+	for (Call::const_fmap_iterator_type i = Call::functions().lower_bound(Tokid(fi, 0));
+	    i != Call::fend() && i->first.get_fileid() == fi; i++)
+		if (c.funs.empty() || c.funs.back() != (cs_offset_t)i->first.get_streampos())
+			c.funs.push_back((cs_offset_t)i->first.get_streampos());
+
+	size_t c_size = size_of(c);
+	shrink(c_size > max_size ? 0 : max_size - c_size);
+	files.push_front(make_pair(fi, std::move(c)));
+	index[fi] = files.begin();
+	size += c_size;
+	return &files.front().second;
+}
@@ -0,0 +1,82 @@
+/*
+ * (C) Copyright 2026 Diomidis Spinellis
+ *
+ * This file is part of CScout.
+ *
+ * CScout is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * CScout is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with CScout.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *
+ * The contents of source files together with the spans that the
+ * hypertext source listings can mark: the identifiers and the
+ * function names they contain.
+ * The spans of a file are found once, when the file is first listed,
+ * and are then kept, so that listings do not need to look up the
+ * equivalence class and functions of every character.
+ * The least recently listed files are discarded when the kept
+ * contents exceed max_size; files that are saved or edited are
+ * discarded through invalidate().
+ * The identifier and function queries of a listing are applied
+ * to the spans, rather than to the file's characters.
+ *
+ */
+
+#ifndef SRCSPANS_
+#define SRCSPANS_
+
+#include <list>
+#include <map>
+#include <string>
+#include <utility>
+#include <vector>
+
+using namespace std;
+
+#include "cpp.h"
+#include "fileid.h"
+
+class Eclass;
+
+class SourceSpans {
+public:
+	// A file's contents and spans
+	struct Contents {
+		string text;			// The file's contents
+		// Identifier spans: their offset and EC, in offset order
+		vector <pair <cs_offset_t, Eclass *> > identifiers;
+		vector <cs_offset_t> funs;	// Offsets of function names
+	};
+private:
+	typedef list <pair <Fileid, Contents> > FileList;
+	static FileList files;		// Most recently listed first
+	static map <Fileid, FileList::iterator> index;
+	static size_t size;		// Size of the kept contents
+	static const size_t max_size = 64 * 1024 * 1024;
+
+	// Return the memory occupied by c
+	static size_t size_of(const Contents &c);
+	// Discard the least recently listed files until size is at most max
+	static void shrink(size_t max);
+public:
+	/*
+	 * Return the contents and spans of file fi, or NULL if it
+	 * cannot be read.
+	 * Hand-edited files are represented by their original contents.
+	 * The result remains valid until the next call.
+	 */
+	static const Contents *get(Fileid fi);
+	// Discard the kept contents of fi
+	static void invalidate(Fileid fi);
+};
+
+#endif /* SRCSPANS_ */
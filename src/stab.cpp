@@ -49,6 +49,7 @@
 #include "ctoken.h"
 #include "type.h"
 #include "stab.h"
+#include "clashcheck.h"
 #include "fdep.h"
 #include "call.h"
 #include "fcall.h"
@@ -61,6 +62,7 @@ int Block::current_block = -1;
 int Block::param_block_nesting = -1;
 vectorBlock Block::scope_block;
 Stab Function::label;
+int Function::scope = -1;
 Block Block::param_block;	// Function parameter declarations
 bool Block::param_use;		// Declare types in param_block when true
 bool Block::param_seen;		// Don't set param_block on scope exit when true
@@ -75,10 +77,28 @@ Id::Id(const Token& tok, Type typ, FCall *fc, GlobObj *go) :
 void
 Block::enter()
 {
-	scope_block.push_back(Block());
+	Block b;
+	// Compilation units are not searched for names beyond their block
+	if (current_block + 1 <= cu_block)
+		b.scope = ClashCheck::block_scope(-1, true);
+	else
+		b.scope = ClashCheck::block_scope(scope_block.back().scope, false);
+	scope_block.push_back(b);
 	current_block++;
 }
 
+// Return the clash checking namespace of a block's table
+static ClashCheck::e_table
+clash_table(const Stab Block::*table)
+{
+	if (table == &Block::obj)
+		return ClashCheck::t_obj;
+	else if (table == &Block::tag)
+		return ClashCheck::t_tag;
+	else
+		return ClashCheck::t_label;
+}
+
 /*
  * Called when entering a function-level block statement
  * Add a scope block with the function's parameters.
@@ -88,6 +108,8 @@ Block::fn_body_enter()
 {
 	if (DP())
 		cout << "On fn_body_enter " << param_block.obj << "\n";
+	if (param_block.scope < 0)
+		param_block.scope = ClashCheck::block_scope(scope_block.back().scope, false);
 	scope_block.push_back(param_block);
 	current_block++;
 	param_use = false;
@@ -142,6 +164,7 @@ void
 Block::define(Stab Block::*table, const Token& tok, const Type& typ, FCall *fc, GlobObj *go)
 {
 	(scope_block[current_block].*table).define(tok, typ, fc, go);
+	ClashCheck::declare(scope_block[current_block].scope, clash_table(table), tok);
 }
 
 // Called when exiting a function block statement
@@ -150,6 +173,7 @@ Block::param_clear(void)
 {
 	param_block.obj.clear();
 	param_block.tag.clear();
+	param_block.scope = -1;
 	param_seen = false;
 	param_block_nesting = current_block;
 	if (DP())
@@ -184,6 +208,7 @@ obj_define(const Token& tok, Type typ)
 			 */
 			Error::error(E_ERR, "declared parameter does not appear in old-style function parameter list: " + tok.get_name());
 		(Block::param_block.obj).define(tok, typ);
+		ClashCheck::declare(Block::param_block.scope, ClashCheck::t_obj, tok);
 		return;
 	}
 	if (sc == c_unspecified && typ.is_cfunction())
@@ -323,6 +348,7 @@ obj_define(const Token& tok, Type typ)
 				}
 			}
 			id = Block::scope_block[Block::lu_block].obj.define(tok, typ, fc, go);
+			ClashCheck::declare(Block::scope_block[Block::lu_block].scope, ClashCheck::t_obj, tok);
 		}
 		/*
 		 * We test go, because it might be null if the object is defined as a function in one
@@ -381,6 +407,7 @@ Block::lookup(const Stab Block::*table, const string& name)
 {
 	Id const * id;
 
+	ClashCheck::use(scope_block[current_block].scope, clash_table(table), name);
 	for (int i = current_block; i != lu_block; i--)
 		if ((id = (scope_block[i].*table).lookup(name)))
 			return pair <Id const *, int>(id, i);
@@ -503,8 +530,10 @@ label_define(const Token& tok)
 	}
 	if (is_local)
 		Block::define(llptr, tok, label());
-	else
+	else {
 		Function::label.define(tok, label());
+		ClashCheck::declare(Function::get_scope(), ClashCheck::t_label, tok);
+	}
 }
 
 /*
@@ -516,12 +545,24 @@ void
 label_use(const Token& tok)
 {
 	Id const *id;
-	if ((id = local_label_lookup(tok.get_name())) == NULL)
+	if ((id = local_label_lookup(tok.get_name())) == NULL) {
 		id = Function::label.lookup(tok.get_name());
+		ClashCheck::use(Function::get_scope(), ClashCheck::t_label, tok.get_name());
+	}
 	if (id)
 		Token::unify(id->get_token(), tok);
-	else
+	else {
 		Function::label.define(tok, Type());
+		ClashCheck::declare(Function::get_scope(), ClashCheck::t_label, tok);
+	}
+}
+
+int
+Function::get_scope()
+{
+	if (scope < 0)
+		scope = ClashCheck::scope();
+	return scope;
 }
 
 // Called at the end of a function definition
@@ -539,6 +580,7 @@ Function::exit()
 			 */
 			Error::error(E_ERR, "undefined label " + Stab::get_name(i));
 	label.clear();
+	scope = -1;
 }
 
 ostream&
@@ -108,10 +108,13 @@ typedef vector<Block> vectorBlock;
 class Function {
 private:
 	static Stab label;
+	static int scope;		// Scope recorded for clash checking
+	// Return the clash checking scope of the function's labels
+	static int get_scope();
 public:
 	// Called when entering or exiting a function
 	// Either call will be enough
-	static void enter() { label.clear(); }
+	static void enter() { label.clear(); scope = -1; }
 	static void exit();
 	friend void label_define(const Token& tok);
 	friend void label_use(const Token& tok);
@@ -149,6 +152,9 @@ public:
 	Stab obj;		// Objects (variables...)
 	Stab tag;		// Aggregate (struct, union) tags
 	Stab local_label;	// Local labels; gcc extension
+	int scope;		// Scope recorded for clash checking
+
+	Block() : scope(-1) {}
 
 	static int get_scope_level() { return current_block; }
 	static void set_scope_level(int level) { current_block = level; }
@@ -39,8 +39,8 @@
  * 1. anoynmous object is initialized via the constructor
  * Fileid::Fileid(const string &name, int i) which:
  *   1.1 uses u2i
- *   1.2 calls Filedetails::add_instance(name, true, FileHash()) using i2d
- *   1.3 calls Filedetails::add_identical_file(FileHash(), *this) using
+ *   1.2 calls Filedetails::add_instance(name, true) using i2d
+ *   1.3 calls Filedetails::add_identical_file(*this, no_contents) using
  *       Filedetails::identical_files
  * Initialize from inside (1.X) to outside.
  */
@@ -48,6 +48,9 @@
 // Map from unique name to id
 FI_uname_to_id Fileid::u2i;
 
+// Map from path spellings seen to id
+FI_path_to_id Fileid::p2i;
+
 // Map from id to file details; first element is anonymous
 FI_id_to_details Filedetails::i2d;
 
@@ -60,11 +60,6 @@ protected:
 	dequeTpart parts;		// Identifiers for constituent parts
 	string val;			// Token character contents (for identifiers)
 public:
-	// Modify class's operation to check for name clashes of refactored ids
-	static bool check_clashes;
-	// True if during checks identifier clashes were detected
-	static bool found_clashes;
-
 	// Unify the constituent equivalence classes for def and ref
 	// The definition/reference order is only required when maintaining
 	// dependency relationships across files
@@ -80,12 +75,10 @@ public:
 	// Accessor method
 	int get_code() const { return (code); }
 	// Return an identifier token's name
-	const string get_name() const { return check_clashes ? get_refactored_name() : val; };
+	const string get_name() const { return val; };
 	const string get_val() const { return get_name(); };
 	// Return the value escaping strings as needed
 	const string get_c_val() const;
-	// Return the name after applying rename identifier refactorings
-	const string get_refactored_name() const;
 	// Return the token's symbolic name based on its code
 	string name() const;
 	// Return the constituent Tokids; they may be more than the parts
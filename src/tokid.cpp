@@ -50,7 +50,7 @@
 #include "eclass.h"
 
 
-mapTokidEclass Tokid::tm;		// Map from tokens to their equivalence
+EcMap Tokid::tm;			// Map from tokens to their equivalence
 
 mapTokidEclass tokid_map;		// Dummy; used for printing
 
@@ -62,38 +62,44 @@ operator<<(ostream& o,const Tokid t)
 }
 
 ostream&
-operator<<(ostream& o,const mapTokidEclass& t)
+operator<<(ostream& o,const mapTokidEclass& dummy)
 {
-	mapTokidEclass::const_iterator i;
-
-	for (i = Tokid::tm.begin(); i != Tokid::tm.end(); i++) {
+	Tokid::for_each_ec([&o](Tokid t, Eclass *e) {
 		// Convert Tokids into Tparts to also display their content
-		Tokid t = (*i).first;
-		Eclass e = *((*i).second);
-		Tpart p(t, e.get_len());
+		Tpart p(t, e->get_len());
 		o << p << ":\n";
-		o << e << "\n\n";
-	}
+		o << *e << "\n\n";
+	});
 	return o;
 }
 
 void
 Tokid::dump_map()
 {
-	cout << tm;
+	cout << tokid_map;
+}
+
+// Return the map's contents as an ordered map
+mapTokidEclass
+Tokid::ordered_map()
+{
+	mapTokidEclass r;
+
+	for_each_ec([&r](Tokid t, Eclass *e) {
+		r.insert(r.end(), mapTokidEclass::value_type(t, e));
+	});
+	return r;
 }
 
 // Clear the map of tokid equivalence classes
 void
 Tokid::clear()
 {
-	mapTokidEclass::const_iterator i;
 	set <Eclass *> es;
 
 	if (DP()) cout << "Have " << Tokid::tm.size() << " tokids\n";
 	// First create a set of all ecs
-	for (i = Tokid::tm.begin(); i != Tokid::tm.end(); i++)
-		es.insert((*i).second);
+	for_each_ec([&es](Tokid t, Eclass *e) { es.insert(e); });
 	// Then free them
 	if (DP()) cout << "Deleting " << es.size() << " classes\n";
 	set <Eclass *>::const_iterator si;
@@ -110,9 +116,9 @@ Tokid::constituents(int l)
 {
 	Tokid t = *this;
 	dequeTpart r;
-	mapTokidEclass::const_iterator e = tm.find(t);
+	Eclass *e = t.check_ec();
 
-	if (e == Tokid::tm.end()) {
+	if (e == NULL) {
 		// No EC defined, create a new one
 		new Eclass(t, l);
 		Tpart tp(t, l);
@@ -122,11 +128,11 @@ Tokid::constituents(int l)
 	// Make r be the Tparts of the ECs covering our tokid t
 	for (;;) {
 		if (DP())
-			cout << "Tokid = " << (e->first) << " Eclass = " << e->second << "\n" << (*(e->second)) << "\n";
-		int covered = (e->second)->get_len();
+			cout << "Tokid = " << t << " Eclass = " << e << "\n" << *e << "\n";
+		int covered = e->get_len();
 		if (!Pdtoken::skipping()) {
 			// Add the existing classes to our current project
-			(e->second)->set_attribute(Project::get_current_projid());
+			e->set_attribute(Project::get_current_projid());
 			if (DP())
 				cout << "Set projid to " << Project::get_current_projid() << "\n";
 		}
@@ -139,10 +145,10 @@ Tokid::constituents(int l)
 		if (l == 0)
 			return (r);
 		t += covered;
-		e = tm.find(t);
-		// csassert(e != Tokid::tm.end());
+		e = t.check_ec();
+		// csassert(e != NULL);
 		// Can only happen if we are deleting ECs with -m
-		if (e == Tokid::tm.end()) {
+		if (e == NULL) {
 			// No EC defined, create a new one covering the rest
 			new Eclass(t, l);
 			Tpart tp(t, l);
@@ -157,26 +163,25 @@ void
 Tokid::set_ec_attribute(enum e_attribute a, int l) const
 {
 	Tokid t = *this;
-	dequeTpart r;
-	mapTokidEclass::const_iterator e = tm.find(t);
+	Eclass *e = t.check_ec();
 
-	if (e == Tokid::tm.end()) {
+	if (e == NULL) {
 		// No EC defined, create a new one
-		Eclass *e = new Eclass(t, l);
+		e = new Eclass(t, l);
 		e->set_attribute(a);
 		return;
 	}
 	// Set the ECs covering our tokid t
 	for (;;) {
-		int covered = (e->second)->get_len();
-		(e->second)->set_attribute(a);
+		int covered = e->get_len();
+		e->set_attribute(a);
 		l -= covered;
 		csassert(l >= 0);
 		if (l == 0)
 			return;
 		t += covered;
-		e = tm.find(t);
-		csassert(e != Tokid::tm.end());
+		e = t.check_ec();
+		csassert(e != NULL);
 	}
 }
 
@@ -185,24 +190,23 @@ bool
 Tokid::has_ec_attribute(enum e_attribute a, int l) const
 {
 	Tokid t = *this;
-	dequeTpart r;
-	mapTokidEclass::const_iterator e = tm.find(t);
+	Eclass *e = t.check_ec();
 
-	if (e == Tokid::tm.end())
-		// No EC defined, create a new one
+	if (e == NULL)
+		// No EC defined
 		return false;
 	// Check the ECs covering our tokid t
 	for (;;) {
-		int covered = (e->second)->get_len();
-		if ((e->second)->get_attribute(a))
+		int covered = e->get_len();
+		if (e->get_attribute(a))
 			return true;
 		l -= covered;
 		csassert(l >= 0);
 		if (l == 0)
 			return false;
 		t += covered;
-		e = tm.find(t);
-		csassert(e != Tokid::tm.end());
+		e = t.check_ec();
+		csassert(e != NULL);
 	}
 }
 
@@ -46,6 +46,7 @@ using namespace std;
 #include "cpp.h"
 #include "fileid.h"
 #include "error.h"
+#include "ecmap.h"
 
 class Eclass;
 
@@ -63,7 +64,7 @@ public:
 #else
 private:
 #endif
-	static mapTokidEclass tm;	// Map from tokens to their equivalence
+	static EcMap tm;		// Map from tokens to their equivalence
 					// classes
 private:
 	Fileid fi;			// File
@@ -97,17 +98,14 @@ public:
 	// Set its equivalence class to ec (done when adding it to an Eclass)
 	// use Eclass:add_tokid, not this method in all other contexts
 	inline void set_ec(Eclass *ec) const;
-	// Return an iterator to the map for this tokid or the end_ec() value
-	mapTokidEclass::iterator find_ec() const { return tm.find(*this); }
-
-	// The map's begin
-	static mapTokidEclass::iterator begin_ec() { return tm.begin(); }
-
-	// The not-found value
-	static mapTokidEclass::iterator end_ec() { return tm.end(); }
+	// Call f(tokid, ec) for all mapped tokids in Tokid order
+	template <typename F> static void for_each_ec(F f);
+	// Return the (offset, EC) pairs of file fi's mapped tokids in offset order
+	static inline vector <pair <cs_offset_t, Eclass *> > file_ecs(Fileid fi);
+	// Return the map's contents as an ordered map (for PICO_QL)
+	static mapTokidEclass ordered_map();
 
 	// Erase the tokid's EC from the map
-	inline void erase_ec(mapTokidEclass::iterator i) const;
 	inline void erase_ec(Eclass *e) const;
 	// Returns the Tokids participating in all ECs for a token of length l
 	dequeTpart constituents(int l);
@@ -127,7 +125,7 @@ public:
 	inline const string& get_path() const { return fi.get_path(); }
 	inline Fileid get_fileid() const { return fi; }
 	inline streampos get_streampos() const { return (streampos)offs; }
-	static map <Tokid, Eclass *>::size_type map_size() { return tm.size(); }
+	static size_t map_size() { return tm.size(); }
 };
 
 // Print dequeTokid sequences
@@ -200,45 +198,47 @@ operator >=(const class Tokid a, const class Tokid b)
 inline Eclass *
 Tokid::get_ec() const
 {
-	return tm[*this];
+	return tm.find(fi.get_id(), offs);
 }
 
 inline Eclass *
 Tokid::check_ec() const
 {
-	mapTokidEclass::const_iterator i = tm.find(*this);
-	if (i == tm.end())
-		return NULL;
-	else
-		return ((*i).second);
+	return tm.find(fi.get_id(), offs);
 }
 
 inline void
 Tokid::set_ec(Eclass *ec) const
 {
-	/*
-	 * tm[*this] = ec;
-	 * Efficiently implement the functionality we need.
-	 * See Meyers Effective STL, Item 24.
-	 */
-	mapTokidEclass::iterator i = tm.lower_bound(*this);
-	if (i != tm.end() && i->first == *this)
-		i->second = ec;
-	else
-		tm.insert(i, mapTokidEclass::value_type(*this, ec));
+	tm.set(fi.get_id(), offs, ec);
 }
 
 inline void
-Tokid::erase_ec(mapTokidEclass::iterator i) const
+Tokid::erase_ec(Eclass *e) const
 {
-	tm.erase(i);
+	bool found = tm.erase(fi.get_id(), offs);
+	csassert(found);
 }
 
-inline void
-Tokid::erase_ec(Eclass *e) const
+template <typename F>
+void
+Tokid::for_each_ec(F f)
+{
+	for (int id = tm.min_id(); id <= tm.max_id(); id++) {
+		const FileEcMap *fm = tm.check_file(id);
+		if (!fm || fm->size() == 0)
+			continue;
+		for (auto &e : fm->sorted())
+			f(Tokid(Fileid(id), e.first), e.second);
+	}
+}
+
+inline vector <pair <cs_offset_t, Eclass *> >
+Tokid::file_ecs(Fileid fi)
 {
-	mapTokidEclass::iterator i = tm.find(*this);
-	csassert(i != tm.end());
-	tm.erase(i);
+	const FileEcMap *fm = tm.check_file(fi.get_id());
+	if (!fm)
+		return vector <pair <cs_offset_t, Eclass *> >();
+	return fm->sorted();
 }
 #endif /* TOKID_ */
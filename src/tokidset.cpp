@@ -0,0 +1,178 @@
+/*
+ * (C) Copyright 2026 Diomidis Spinellis
+ *
+ * This file is part of CScout.
+ *
+ * CScout is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * CScout is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with CScout.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *
+ * For documentation read the corresponding .h file
+ *
+ */
+
+#include <algorithm>
+#include <cstring>
+#include <new>
+#include <vector>
+
+#include "tokid.h"
+#include "tokidset.h"
+
+const TokidSet::size_type TokidSet::inline_size;
+
+// Allocate uninitialized storage for n Tokids
+static Tokid *
+allocate(TokidSet::size_type n)
+{
+	return static_cast<Tokid *>(::operator new(n * sizeof(Tokid)));
+}
+
+TokidSet::TokidSet(const TokidSet &s) : len(0), cap(inline_size)
+{
+	reserve(s.len);
+	memcpy(data(), s.data(), s.len * sizeof(Tokid));
+	len = s.len;
+}
+
+TokidSet &
+TokidSet::operator=(const TokidSet &s)
+{
+	if (this != &s) {
+		len = 0;
+		reserve(s.len);
+		memcpy(data(), s.data(), s.len * sizeof(Tokid));
+		len = s.len;
+	}
+	return *this;
+}
+
+void
+TokidSet::release()
+{
+	if (cap > inline_size)
+		::operator delete(u.heap);
+	len = 0;
+	cap = inline_size;
+}
+
+void
+TokidSet::reserve(size_type n)
+{
+	if (n <= cap)
+		return;
+	size_type ncap = cap * 2;
+	if (ncap < n)
+		ncap = n;
+	Tokid *p = allocate(ncap);
+	memcpy(p, data(), len * sizeof(Tokid));
+	if (cap > inline_size)
+		::operator delete(u.heap);
+	u.heap = p;
+	cap = ncap;
+}
+
+TokidSet::const_iterator
+TokidSet::find(Tokid t) const
+{
+	const_iterator i = lower_bound(begin(), end(), t);
+	return (i != end() && *i == t) ? i : end();
+}
+
+bool
+TokidSet::insert(Tokid t)
+{
+	// Common case: appending in order
+	if (len == 0 || data()[len - 1] < t) {
+		reserve(len + 1);
+		data()[len++] = t;
+		return true;
+	}
+	Tokid *i = lower_bound(data(), data() + len, t);
+	if (*i == t)
+		return false;
+	size_type pos = i - data();
+	reserve(len + 1);
+	Tokid *d = data();
+	memmove(d + pos + 1, d + pos, (len - pos) * sizeof(Tokid));
+	d[pos] = t;
+	len++;
+	return true;
+}
+
+bool
+TokidSet::erase(Tokid t)
+{
+	Tokid *d = data();
+	Tokid *i = lower_bound(d, d + len, t);
+	if (i == d + len || !(*i == t))
+		return false;
+	memmove(i, i + 1, (d + len - i - 1) * sizeof(Tokid));
+	len--;
+	return true;
+}
+
+void
+TokidSet::merge(const TokidSet &s)
+{
+	if (s.len == 0 || this == &s)
+		return;
+	// Common case: the members of s follow ours
+	if (len == 0 || data()[len - 1] < *s.begin()) {
+		reserve(len + s.len);
+		memcpy(data() + len, s.data(), s.len * sizeof(Tokid));
+		len += s.len;
+		return;
+	}
+	/*
+	 * A much smaller set: merge its new members in place from the end,
+	 * so that only our members following them are moved.
+	 * Merging into new storage would copy all our members.
+	 */
+	if (s.len * 8 < len) {
+		vector <Tokid> add;
+		const Tokid *from = data(), *to = data() + len;
+		for (const_iterator i = s.begin(); i != s.end(); i++) {
+			from = lower_bound(from, to, *i);
+			if (from == to || !(*from == *i))
+				add.push_back(*i);
+		}
+		if (add.empty())
+			return;
+		reserve(len + add.size());
+		Tokid *d = data();
+		Tokid *src = d + len;
+		Tokid *dst = d + len + add.size();
+		for (size_type j = add.size(); j > 0;)
+			if (src > d && add[j - 1] < src[-1])
+				*--dst = *--src;
+			else
+				*--dst = add[--j];
+		len += add.size();
+		return;
+	}
+	// Sets of similar size: linear merge into new storage
+	size_type n = len + s.len;
+	Tokid *p = allocate(n);
+	size_type nlen = set_union(begin(), end(), s.begin(), s.end(), p) - p;
+	if (n <= cap) {
+		memcpy(data(), p, nlen * sizeof(Tokid));
+		::operator delete(p);
+	} else {
+		if (cap > inline_size)
+			::operator delete(u.heap);
+		u.heap = p;
+		cap = n;
+	}
+	len = nlen;
+}
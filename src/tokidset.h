@@ -0,0 +1,82 @@
+/*
+ * (C) Copyright 2026 Diomidis Spinellis
+ *
+ * This file is part of CScout.
+ *
+ * CScout is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * CScout is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with CScout.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *
+ * A compact ordered set of Tokids, used for storing the members
+ * of equivalence classes.
+ *
+ * Rationale: a set<Tokid> costs a tree node (about three times the
+ * size of a Tokid) for every identifier occurrence.  Here members are
+ * kept in a sorted array.  Small sets, which are the vast majority,
+ * are stored inline without any heap allocation.
+ * Tokids are mostly added in increasing order, so insertion
+ * typically appends at the end, and merging two sets is a linear
+ * operation.
+ *
+ */
+
+#ifndef TOKIDSET_
+#define TOKIDSET_
+
+#include "tokid.h"
+
+class TokidSet {
+public:
+	typedef const Tokid *const_iterator;
+	typedef const_iterator iterator;	// Members cannot be modified
+	typedef unsigned size_type;
+private:
+	static const size_type inline_size = 2;	// Members stored inline
+
+	size_type len;			// Number of members
+	size_type cap;			// Capacity; inline_size if stored inline
+	union {
+		Tokid *heap;		// Members of a large set
+		char small[inline_size * sizeof(Tokid)];	// of a small one
+	} u;
+
+	Tokid *data() { return cap > inline_size ? u.heap : (Tokid *)u.small; }
+	const Tokid *data() const { return cap > inline_size ? u.heap : (const Tokid *)u.small; }
+	// Ensure there is space for n members
+	void reserve(size_type n);
+	// Free heap storage, making the set an empty inline one
+	void release();
+public:
+	TokidSet() : len(0), cap(inline_size) {}
+	TokidSet(const TokidSet &s);
+	TokidSet &operator=(const TokidSet &s);
+	~TokidSet() { release(); }
+
+	const_iterator begin() const { return data(); }
+	const_iterator end() const { return data() + len; }
+	size_type size() const { return len; }
+	bool empty() const { return len == 0; }
+	// Return an iterator to t or end() if t is not a member
+	const_iterator find(Tokid t) const;
+	size_type count(Tokid t) const { return find(t) != end(); }
+
+	// Add t; return false if it is already a member
+	bool insert(Tokid t);
+	// Remove t; return false if it is not a member
+	bool erase(Tokid t);
+	// Add all members of s
+	void merge(const TokidSet &s);
+	void clear() { release(); }
+};
+
+#endif /* TOKIDSET_ */
@@ -50,6 +50,7 @@
 #include "type.h"
 #include "stab.h"
 #include "type2.h"
+#include "clashcheck.h"
 #include "debug.h"
 #include "fchar.h"
 #include "call.h"
@@ -537,15 +538,17 @@ Tsu::print(ostream &o) const
  *   lookups also work as expected.
  */
 Tsu::Tsu(Tsu_unnamed a, const Type &typ) :
-		default_specifier(basic(b_undeclared)), is_union(false) {
+		default_specifier(basic(b_undeclared)), is_union(false), scope(-1) {
 
 	members_by_ordinal.push_back(Id(typ));
 
 	csassert(typ.is_su());
 	const Stab &s = typ.get_members_by_name();
 	Stab_element::const_iterator i;
-	for (i = s.begin(); i != s.end(); i++)
+	for (i = s.begin(); i != s.end(); i++) {
 		members_by_name.define(i->second.get_token(), i->second.get_type());
+		declare_member(i->second.get_token());
+	}
 
 	if (DP()) {
 		cout << "Added unnamed member [" << typ << ']' << endl;
@@ -554,6 +557,16 @@ Tsu::Tsu(Tsu_unnamed a, const Type &typ) :
 	}
 }
 
+void
+Tsu::declare_member(const Token &tok)
+{
+	if (!ClashCheck::is_enabled())
+		return;
+	if (scope < 0)
+		scope = ClashCheck::scope();
+	ClashCheck::declare(scope, ClashCheck::t_member, tok);
+}
+
 void
 Tincomplete::print(ostream &o) const
 {
@@ -695,7 +708,7 @@ Tsu::merge(Tbasic *b)
 		c = this->get_storage_class();
 
 	q = (enum e_qualifier)(this->get_qualifiers() | b->get_qualifiers());
-	return Type(new Tsu(members_by_name, members_by_ordinal, default_specifier.clone(), c, q, is_union));
+	return Type(new Tsu(members_by_name, members_by_ordinal, default_specifier.clone(), c, q, is_union, scope));
 }
 
 Type
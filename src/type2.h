@@ -128,13 +128,18 @@ private:
 	Type default_specifier;	// Used while declaring a series of members
 	Tstorage sclass;
 	bool is_union;		// True if this is a union
+	int scope;		// Members scope recorded for clash checking
+	// Record the declaration of member tok for clash checking
+	void declare_member(const Token &tok);
 public:
 	Tsu(const Token &tok, const Type &typ, const Type &spec) :
 		default_specifier(spec),
-		is_union(false)
+		is_union(false),
+		scope(-1)
 	{
 		tok.set_ec_attribute(is_sumember);
 		members_by_name.define(tok, typ);
+		declare_member(tok);
 		members_by_ordinal.push_back(Id(tok, typ));
 		if (DP()) {
 			cout << "Added member " << tok << endl;
@@ -142,16 +147,17 @@ public:
 		}
 	}
 	Tsu(Tsu_unnamed dummy, const Type &typ);
-	Tsu(const Stab &mbn, const vector <Id> &mbo, Type ds, enum e_storage_class sc, qualifiers_t q, bool u) :
+	Tsu(const Stab &mbn, const vector <Id> &mbo, Type ds, enum e_storage_class sc, qualifiers_t q, bool u, int s) :
 			QType_node(q),
 			members_by_name(mbn),
 			members_by_ordinal(mbo),
 			default_specifier(ds),
 			sclass(sc),
-			is_union(u)
+			is_union(u),
+			scope(s)
 			{}
-	Tsu(const Type &spec) : default_specifier(spec), is_union(false) {}
-	Tsu() : is_union(false) {}
+	Tsu(const Type &spec) : default_specifier(spec), is_union(false), scope(-1) {}
+	Tsu() : is_union(false), scope(-1) {}
 	virtual ~Tsu() {}
 	// Return number of elements
 	CTConst get_nelem() const {
@@ -160,10 +166,11 @@ public:
 	bool is_su() const { return true; }
 	// Indicate this is a union
 	void set_union(bool v) { is_union = v; }
-	Type clone() const { return Type(new Tsu(members_by_name, members_by_ordinal, default_specifier.clone(), sclass.get_storage_class(), get_qualifiers(), is_union)); }
+	Type clone() const { return Type(new Tsu(members_by_name, members_by_ordinal, default_specifier.clone(), sclass.get_storage_class(), get_qualifiers(), is_union, scope)); }
 	void add_member(const Token &tok, const Type &typ) {
 		tok.set_ec_attribute(is_sumember);
 		members_by_name.define(tok, typ);
+		declare_member(tok);
 		members_by_ordinal.push_back(Id(tok, typ));
 		if (DP()) {
 			cout << "Added member " << tok << endl;
@@ -175,6 +182,9 @@ public:
 		if (DP())
 			cout << "Merge: " << Type(this) << " with: " << t << endl;
 		members_by_name.merge_with(t.get_members_by_name());
+		const Stab &s = t.get_members_by_name();
+		for (Stab_element::const_iterator i = s.begin(); i != s.end(); i++)
+			declare_member(i->second.get_token());
 		const vector <Id> &m2 = t.get_members_by_ordinal();
 		members_by_ordinal.insert(members_by_ordinal.end(), m2.begin(), m2.end());
 		if (DP())
@@ -33,6 +33,7 @@
 #include <list>
 #include <set>
 #include <sstream>		// ostringstream
+#include <algorithm>		// min
 #include <cstdio>		// perror
 
 #include "cpp.h"
@@ -59,6 +60,7 @@
 #include "type.h"
 #include "stab.h"
 #include "sql.h"
+#include "parallel.h"
 #include "workdb.h"
 
 // Tables that are disabled (by default none)
@@ -153,56 +155,70 @@ insert_eclass(Sql *db, ostream &of, Eclass *e, const string &name)
 	id_msum.add_unique_id(e);
 
 	if (table_is_enabled(t_ids))
-		of << "INSERT INTO IDS VALUES(" <<
-		     ptr_offset(e) << ",'" <<
-		     name << "'," <<
-		     db->boolval(e->get_attribute(is_readonly)) << ',' <<
-		     db->boolval(e->get_attribute(is_undefined_macro)) << ',' <<
-		     db->boolval(e->get_attribute(is_macro)) << ',' <<
-		     db->boolval(e->get_attribute(is_macro_arg)) << ',' <<
-		     db->boolval(e->get_attribute(is_ordinary)) << ',' <<
-		     db->boolval(e->get_attribute(is_suetag)) << ',' <<
-		     db->boolval(e->get_attribute(is_sumember)) << ',' <<
-		     db->boolval(e->get_attribute(is_label)) << ',' <<
-		     db->boolval(e->get_attribute(is_typedef)) << ',' <<
-		     db->boolval(e->get_attribute(is_enumeration)) << ',' <<
-		     db->boolval(e->get_attribute(is_yacc)) << ',' <<
-		     db->boolval(e->get_attribute(is_cfunction)) << ',' <<
-		     db->boolval(e->get_attribute(is_cscope)) << ',' <<
-		     db->boolval(e->get_attribute(is_lscope)) << ',' <<
-		     db->boolval(e->is_unused()) <<
-		     ");\n";
+		SqlRow(db, of, "IDS") <<
+		     ptr_offset(e) <<
+		     name <<
+		     e->get_attribute(is_readonly) <<
+		     e->get_attribute(is_undefined_macro) <<
+		     e->get_attribute(is_macro) <<
+		     e->get_attribute(is_macro_arg) <<
+		     e->get_attribute(is_ordinary) <<
+		     e->get_attribute(is_suetag) <<
+		     e->get_attribute(is_sumember) <<
+		     e->get_attribute(is_label) <<
+		     e->get_attribute(is_typedef) <<
+		     e->get_attribute(is_enumeration) <<
+		     e->get_attribute(is_yacc) <<
+		     e->get_attribute(is_cfunction) <<
+		     e->get_attribute(is_cscope) <<
+		     e->get_attribute(is_lscope) <<
+		     e->is_unused();
 	// The projects each EC belongs to
 	if (table_is_enabled(t_idproj))
 		for (unsigned j = attr_end; j < Attributes::get_num_attributes(); j++)
 			if (e->get_attribute(j))
-				of << "INSERT INTO IDPROJ VALUES("
-				    << ptr_offset(e) << ',' << j << ");\n";
+				SqlRow(db, of, "IDPROJ") << ptr_offset(e) << j;
 }
 
+/*
+ * The table rows of a file.
+ * These are produced concurrently for many files, and then
+ * output serially, in file order.
+ */
+struct FileDump {
+	SqlRowBuffer rows;		// The file's table rows
+	// An identifier appearing in the file
+	struct Identifier {
+		size_t row;		// Number of rows preceding it
+		Eclass *ec;		// Its equivalence class
+		string name;		// Its name
+		Identifier(size_t r, Eclass *e, const string &n) : row(r), ec(e), name(n) {}
+	};
+	// Identifiers, whose equivalence classes are output serially
+	vector <Identifier> ids;
+};
+
 // Chunk the input into tables
 class Chunker {
 private:
 	fifstream &in;		// Stream we are reading from
-	string table;		// Table we are chunking into
+	const char *table;	// Table we are chunking into
 	Sql *db;		// Database interface
-	ostream &of;		// Stream for writing SQL statements
+	SqlRowBuffer &of;	// Buffer for the table rows
 	Fileid fid;		// File we are chunking
 	streampos startpos;	// Starting position of current chunk
 	string chunk;		// Characters accumulated in the current chunk
 public:
 	bool enabled;		// True if output to the table is enabled
-	Chunker(fifstream &i, Sql *d, ostream &o, Fileid f) : in(i), table("REST"), db(d), of(o), fid(f), startpos(0), enabled(table_is_enabled(t_rest)) {}
+	Chunker(fifstream &i, Sql *d, SqlRowBuffer &o, Fileid f) : in(i), table("REST"), db(d), of(o), fid(f), startpos(0), enabled(table_is_enabled(t_rest)) {}
 
 	// Flush the currently collected input into the database
 	// Should be called at the point where new input is expected
 	void flush() {
 		if (chunk.length() > 0) {
 			if (enabled)
-				of << "INSERT INTO " << table << " VALUES("
-				    << fid.get_id()
-				    << "," << (unsigned)startpos
-				    << ",'" << chunk << "');\n";
+				SqlRow(db, of, table) << fid.get_id() <<
+				    (unsigned)startpos << chunk;
 			chunk.erase();
 		}
 		startpos = in.tellg();
@@ -214,9 +230,9 @@ public:
 	// s can be input already collected
 	void start(const char *t, bool e, const string &s = string("")) {
 		flush();
-		table = string(t);
+		table = t;
 		startpos -= s.length();
-		chunk = db->escape(s);
+		chunk = s;
 		enabled = e;
 	}
 
@@ -225,15 +241,15 @@ public:
 	}
 
 	inline void add(char c) {
-		chunk += db->escape(c);
+		chunk += c;
 	}
 };
 
 // Add the contents of a file to the Tokens, Comments, Strings, and Rest tables
-// As a side-effect insert corresponding identifiers in the database
+// As a side-effect record the corresponding identifiers
 // and populate the LineOffset table
 static void
-file_dump(Sql *db, ostream &of, Fileid fid)
+file_dump(Sql *db, FileDump &d, Fileid fid)
 {
 	streampos bol(0);			// Beginning of line
 	bool at_bol = true;
@@ -241,12 +257,12 @@ file_dump(Sql *db, ostream &of, Fileid fid)
 	enum e_cfile_state cstate = s_normal;	// C file state machine
 
 	fifstream in;
-	in.open(fid.get_path().c_str(), ios::binary);
+	in.open(fid);
 	if (in.fail()) {
 		perror(fid.get_path().c_str());
 		exit(1);
 	}
-	Chunker chunker(in, db, of, fid);
+	Chunker chunker(in, db, d.rows, fid);
 	// Go through the file character by character
 	for (;;) {
 		Tokid ti;
@@ -270,20 +286,17 @@ file_dump(Sql *db, ostream &of, Fileid fid)
 		    (isalnum(c) || c == '_') &&
 		    (ec = ti.check_ec()) &&
 		    ec->is_identifier()) {
-			id_msum.add_pre_cpp_id(ec);
 			string s;
 			s = (char)val;
 			int len = ec->get_len();
 			for (int j = 1; j < len; j++)
 				s += (char)in.get();
-			insert_eclass(db, of, ec, s);
+			d.ids.push_back(FileDump::Identifier(d.rows.size(), ec, s));
 			Filedetails::get_pre_cpp_metrics(fid).process_identifier(s, ec);
 			chunker.flush();
 			if (table_is_enabled(t_tokens))
-				of << "INSERT INTO TOKENS VALUES("
-				    << fid.get_id() << ","
-				    << (unsigned)ti.get_streampos() << ","
-				    << ptr_offset(ec) << ");\n";
+				SqlRow(db, d.rows, "TOKENS") << fid.get_id() <<
+				    (unsigned)ti.get_streampos() << ptr_offset(ec);
 		} else {
 			Filedetails::get_pre_cpp_metrics(fid).process_char(c);
 			if (c == '\n') {
@@ -293,11 +306,8 @@ file_dump(Sql *db, ostream &of, Fileid fid)
 			} else {
 				if (at_bol) {
 					if (table_is_enabled(t_linepos))
-						of << "INSERT INTO LINEPOS VALUES("
-						    << fid.get_id()
-						    << "," << (unsigned)bol
-						    << "," << line_number
-						    << ");\n";
+						SqlRow(db, d.rows, "LINEPOS") << fid.get_id() <<
+						    (unsigned)bol << line_number;
 					at_bol = false;
 				}
 			}
@@ -377,11 +387,73 @@ file_dump(Sql *db, ostream &of, Fileid fid)
 	chunker.flush();
 }
 
+/*
+ * Produce the table rows of the specified file's details and contents.
+ * This can be called concurrently for different files.
+ */
+static void
+file_rows(Sql *db, FileDump &d, Fileid fid)
+{
+	if (table_is_enabled(t_files)) {
+		SqlRow(db, d.rows, "FILES") << fid.get_id() <<
+		    fid.get_path() << fid.get_readonly();
+		// Pre-cpp
+		{
+			SqlRow row(db, d.rows, "FILEMETRICS");
+			row << fid.get_id() << true;
+			for (int j = 0; j < FileMetrics::metric_max; j++) {
+				if (Metrics::is_internal<FileMetrics>(j))
+					continue;
+				if (Metrics::is_pre_cpp<FileMetrics>(j))
+					row << Filedetails::get_pre_cpp_metrics(fid).get_metric(j);
+				else
+					row.null();
+			}
+		}
+		// Post-cpp
+		{
+			SqlRow row(db, d.rows, "FILEMETRICS");
+			row << fid.get_id() << false;
+			for (int j = 0; j < FileMetrics::metric_max; j++) {
+				if (Metrics::is_internal<FileMetrics>(j))
+					continue;
+				if (Metrics::is_post_cpp<FileMetrics>(j))
+					row << Filedetails::get_post_cpp_metrics(fid).get_metric(j);
+				else
+					row.null();
+			}
+		}
+	}
+	// This invalidates the file's metrics
+	file_dump(db, d, fid);
+	// The projects this file belongs to
+	for (unsigned j = attr_end; j < Attributes::get_num_attributes(); j++)
+		if (Filedetails::get_attribute(fid, j) && table_is_enabled(t_fileproj))
+			SqlRow(db, d.rows, "FILEPROJ") << fid.get_id() << j;
+}
+
+/*
+ * Output the rows produced for a file, inserting before them
+ * the equivalence classes of its identifiers.
+ * As a side effect populate the EC identifier member.
+ */
+static void
+file_output(Sql *db, ostream &of, const FileDump &d)
+{
+	size_t row = 0;
+	for (vector <FileDump::Identifier>::const_iterator i = d.ids.begin(); i != d.ids.end(); i++) {
+		d.rows.output(db, of, row, i->row);
+		row = i->row;
+		id_msum.add_pre_cpp_id(i->ec);
+		insert_eclass(db, of, i->ec, i->name);
+	}
+	d.rows.output(db, of, row, d.rows.size());
+}
 
 void
 workdb_schema(Sql *db, ostream &of)
 {
-	if (table_is_enabled(t_ids)) cout <<
+	if (table_is_enabled(t_ids)) of <<
 		"-- Details of interdependant identifiers appearing in the workspace\n"
 		"CREATE TABLE IDS(\n"
 		"  EID " << db->ptrtype() << " PRIMARY KEY, -- Unique identifier key\n"
@@ -403,7 +475,7 @@ workdb_schema(Sql *db, ostream &of)
 		"  UNUSED " << db->booltype() << " -- True if it is not used\n"
 		");\n";
 
-	if (table_is_enabled(t_files)) cout <<
+	if (table_is_enabled(t_files)) of <<
 		"\n\n-- File details\n"
 		"CREATE TABLE FILES(\n"
 		"  FID INTEGER PRIMARY KEY, -- Unique file key\n"
@@ -412,7 +484,7 @@ workdb_schema(Sql *db, ostream &of)
 		");\n";
 
 	if (table_is_enabled(t_filemetrics)) {
-		cout
+		of
 		    << "\n\n-- File metrics\n"
 		    << "CREATE TABLE FILEMETRICS(\n"
 		    "  FID INTEGER, -- File key\n"
@@ -422,19 +494,19 @@ workdb_schema(Sql *db, ostream &of)
 
 		for (int i = 0; i < FileMetrics::metric_max; i++)
 			if (!Metrics::is_internal<FileMetrics>(i))
-				cout
+				of
 				    << "  "
 				    << Metrics::get_dbfield<FileMetrics>(i)
 				    << " INTEGER, -- "
 				    << Metrics::get_name<FileMetrics>(i)
 				    << "\n";
-		cout <<
+		of <<
 		    "  PRIMARY KEY(FID, PRECPP),\n"
 		    "  FOREIGN KEY(FID) REFERENCES FILES(FID)\n"
 		    ");\n";
 }
 
-	if (table_is_enabled(t_tokens)) cout <<
+	if (table_is_enabled(t_tokens)) of <<
 		"\n\n-- Instances of identifier tokens within the source code\n"
 		"CREATE TABLE TOKENS(\n"
 		"  FID INTEGER, -- File key\n"
@@ -445,7 +517,7 @@ workdb_schema(Sql *db, ostream &of)
 		"  FOREIGN KEY(EID) REFERENCES IDS(EID)\n"
 		");\n";
 
-	if (table_is_enabled(t_comments)) cout <<
+	if (table_is_enabled(t_comments)) of <<
 		"\n\n-- Comments in the code\n"
 		"CREATE TABLE COMMENTS(\n"
 		"  FID INTEGER, -- File key\n"
@@ -455,7 +527,7 @@ workdb_schema(Sql *db, ostream &of)
 		"  FOREIGN KEY(FID) REFERENCES FILES(FID)\n"
 		");\n";
 
-	if (table_is_enabled(t_strings)) cout <<
+	if (table_is_enabled(t_strings)) of <<
 		"\n\n-- Strings in the code\n"
 		"CREATE TABLE STRINGS(\n"
 		"  FID INTEGER, -- File key\n"
@@ -465,7 +537,7 @@ workdb_schema(Sql *db, ostream &of)
 		"  FOREIGN KEY(FID) REFERENCES FILES(FID)\n"
 		");\n";
 
-	if (table_is_enabled(t_rest)) cout <<
+	if (table_is_enabled(t_rest)) of <<
 		"\n\n-- Remaining, non-identifier source code\n"
 		"CREATE TABLE REST(\n"
 		"  FID INTEGER, -- File key\n"
@@ -475,7 +547,7 @@ workdb_schema(Sql *db, ostream &of)
 		"  FOREIGN KEY(FID) REFERENCES FILES(FID)\n"
 		");\n";
 
-	if (table_is_enabled(t_linepos)) cout <<
+	if (table_is_enabled(t_linepos)) of <<
 		"\n\n-- Line number offsets within each file\n"
 		"CREATE TABLE LINEPOS(\n"
 		"  FID INTEGER, -- File key\n"
@@ -486,14 +558,14 @@ workdb_schema(Sql *db, ostream &of)
 		");\n";
 
 
-	if (table_is_enabled(t_projects)) cout <<
+	if (table_is_enabled(t_projects)) of <<
 		"\n\n-- Project details\n"
 		"CREATE TABLE PROJECTS(\n"
 		"  PID INTEGER PRIMARY KEY, -- Unique project key\n"
 		"  NAME " << db->varchar() << " -- Project name\n"
 		");\n";
 
-	if (table_is_enabled(t_idproj)) cout <<
+	if (table_is_enabled(t_idproj)) of <<
 		"\n\n-- Identifiers appearing in projects\n"
 		"CREATE TABLE IDPROJ(\n"
 		"  EID " << db->ptrtype() << ", -- Identifier key\n"
@@ -502,7 +574,7 @@ workdb_schema(Sql *db, ostream &of)
 		"  FOREIGN KEY(PID) REFERENCES PROJECTS(PID)\n"
 		");\n";
 
-	if (table_is_enabled(t_fileproj)) cout <<
+	if (table_is_enabled(t_fileproj)) of <<
 		"\n\n-- Files used in projects\n"
 		"CREATE TABLE FILEPROJ(\n"
 		"  FID INTEGER, -- File key\n"
@@ -510,7 +582,7 @@ workdb_schema(Sql *db, ostream &of)
 		"  FOREIGN KEY(FID) REFERENCES FILES(FID),\n"
 		"  FOREIGN KEY(PID) REFERENCES PROJECTS(PID)\n"
 		");\n";
-	cout <<
+	of <<
 	    "\n\n"
 	    "-- Foreign keys for the following four tables are not specified, because it is\n" 
 	    "-- difficult to satisfy integrity constraints: files (esp. their metrics,\n" 
@@ -519,7 +591,7 @@ workdb_schema(Sql *db, ostream &of)
 	    "-- Alternatively, inserts to these tables could be wrapped into\n" 
 	    "-- SET REFERENTIAL_INTEGRITY { TRUE | FALSE } calls.\n";
 
-	if (table_is_enabled(t_definers)) cout <<
+	if (table_is_enabled(t_definers)) of <<
 		"\n\n-- Included files defining required elements for a given compilation unit and project\n"
 		"CREATE TABLE DEFINERS(\n"
 		"  PID INTEGER, -- Project key\n"
@@ -532,7 +604,7 @@ workdb_schema(Sql *db, ostream &of)
 		"  -- FOREIGN KEY(DEFINERID) REFERENCES FILES(FID)\n"
 		");\n";
 
-	if (table_is_enabled(t_includers)) cout <<
+	if (table_is_enabled(t_includers)) of <<
 		"\n\n-- Included files including files for a given compilation unit and project\n"
 		"CREATE TABLE INCLUDERS(\n"
 		"  PID INTEGER, -- Project key\n"
@@ -545,7 +617,7 @@ workdb_schema(Sql *db, ostream &of)
 		"  -- FOREIGN KEY(INCLUDERID) REFERENCES FILES(FID)\n"
 		");\n";
 
-	if (table_is_enabled(t_providers)) cout <<
+	if (table_is_enabled(t_providers)) of <<
 		"\n\n-- Included files providing code or data for a given compilation unit and project\n"
 		"CREATE TABLE PROVIDERS(\n"
 		"  PID INTEGER, -- Project key\n"
@@ -556,7 +628,7 @@ workdb_schema(Sql *db, ostream &of)
 		"  -- FOREIGN KEY(PROVIDERID) REFERENCES FILES(FID)\n"
 		");\n";
 
-	if (table_is_enabled(t_inctriggers)) cout <<
+	if (table_is_enabled(t_inctriggers)) of <<
 		"\n\n-- Tokens requiring file inclusion for a given compilation unit and project\n"
 		"CREATE TABLE INCTRIGGERS(\n"
 		"  PID INTEGER, -- Project key\n"
@@ -571,7 +643,7 @@ workdb_schema(Sql *db, ostream &of)
 		"  -- FOREIGN KEY(DEFINERID) REFERENCES FILES(FID)\n"
 		");\n";
 
-	if (table_is_enabled(t_functions)) cout <<
+	if (table_is_enabled(t_functions)) of <<
 		"\n\n-- C functions and function-like macros\n"
 		"CREATE TABLE FUNCTIONS(\n"
 		"  ID " << db->ptrtype() << " PRIMARY KEY, -- Unique function identifier\n"
@@ -586,7 +658,7 @@ workdb_schema(Sql *db, ostream &of)
 		"  FOREIGN KEY(FID) REFERENCES FILES(FID)\n"
 		");\n";
 
-	if (table_is_enabled(t_functiondefs)) cout <<
+	if (table_is_enabled(t_functiondefs)) of <<
 		"\n\n-- Details of defined functions and macros\n"
 		"CREATE TABLE FUNCTIONDEFS(\n"
 		"  FUNCTIONID " << db->ptrtype() << " PRIMARY KEY, -- Function identifier key\n"
@@ -598,7 +670,7 @@ workdb_schema(Sql *db, ostream &of)
 		");\n";
 
 	if (table_is_enabled(t_functionmetrics)) {
-		cout
+		of
 		    << "\n\n-- Metrics of defined functions and macros\n"
 		    << "CREATE TABLE FUNCTIONMETRICS(\n"
 		    "  FUNCTIONID " << db->ptrtype() << ", -- Function identifier key\n"
@@ -606,7 +678,7 @@ workdb_schema(Sql *db, ostream &of)
 
 		for (int i = 0; i < FunMetrics::metric_max; i++)
 			if (!Metrics::is_internal<FunMetrics>(i))
-				cout
+				of
 				    << "  "
 				    << Metrics::get_dbfield<FunMetrics>(i)
 				    << (i >= FunMetrics::em_real_start
@@ -614,13 +686,13 @@ workdb_schema(Sql *db, ostream &of)
 				    << ", -- "
 				    << Metrics::get_name<FunMetrics>(i)
 				    << "\n";
-		cout <<
+		of <<
 		    "  PRIMARY KEY(FUNCTIONID, PRECPP),\n"
 		    "  FOREIGN KEY(FUNCTIONID) REFERENCES FUNCTIONS(ID)\n"
 		    ");\n";
 	}
 
-	if (table_is_enabled(t_functionid)) cout <<
+	if (table_is_enabled(t_functionid)) of <<
 		"\n\n-- Identifiers comprising a function's name\n"
 		"CREATE TABLE FUNCTIONID(\n"
 		"  FUNCTIONID " << db->ptrtype() << ", -- Function identifier key\n"
@@ -631,7 +703,7 @@ workdb_schema(Sql *db, ostream &of)
 		"  FOREIGN KEY(EID) REFERENCES IDS(EID)\n"
 		");\n";
 
-	if (table_is_enabled(t_fcalls)) cout <<
+	if (table_is_enabled(t_fcalls)) of <<
 		"\n\n-- Function calls\n"
 		"CREATE TABLE FCALLS(\n"
 		"  SOURCEID " << db->ptrtype() << ", -- Calling function identifier key\n"
@@ -640,7 +712,7 @@ workdb_schema(Sql *db, ostream &of)
 		"  FOREIGN KEY(DESTID) REFERENCES FUNCTIONS(ID)\n"
 		");\n";
 
-	if (table_is_enabled(t_filecopies)) cout <<
+	if (table_is_enabled(t_filecopies)) of <<
 		"\n\n-- Files occuring in more than one copy\n"
 		"CREATE TABLE FILECOPIES(\n"
 		"  GROUPID INTEGER, -- File group identifier\n"
@@ -650,6 +722,25 @@ workdb_schema(Sql *db, ostream &of)
 		");\n";
 }
 
+void
+workdb_indexes(ostream &of)
+{
+	if (table_is_enabled(t_tokens))
+		of << "CREATE INDEX TOKENS_EID ON TOKENS(EID);\n";
+	if (table_is_enabled(t_idproj))
+		of << "CREATE INDEX IDPROJ_EID ON IDPROJ(EID);\n";
+	if (table_is_enabled(t_fileproj))
+		of << "CREATE INDEX FILEPROJ_FID ON FILEPROJ(FID);\n";
+	if (table_is_enabled(t_functions))
+		of << "CREATE INDEX FUNCTIONS_FID ON FUNCTIONS(FID, FOFFSET);\n";
+	if (table_is_enabled(t_functionid))
+		of << "CREATE INDEX FUNCTIONID_EID ON FUNCTIONID(EID);\n";
+	if (table_is_enabled(t_fcalls)) {
+		of << "CREATE INDEX FCALLS_SOURCEID ON FCALLS(SOURCEID);\n";
+		of << "CREATE INDEX FCALLS_DESTID ON FCALLS(DESTID);\n";
+	}
+}
+
 void
 workdb_rest(Sql *db, ostream &of)
 {
@@ -658,67 +749,39 @@ workdb_rest(Sql *db, ostream &of)
 	Project::proj_map_type::const_iterator pm;
 	if (table_is_enabled(t_projects))
 		for (pm = m.begin(); pm != m.end(); pm++)
-			cout << "INSERT INTO PROJECTS VALUES("
-				<< pm->second << ",'" << pm->first << "');\n";
+			SqlRow(db, of, "PROJECTS") << pm->second << pm->first;
 
 	vector <Fileid> files = Fileid::files(true);
 
 	int groupnum = 0;
 
-	// Details and contents of each file
-	// As a side effect populate the EC identifier member
-	for (vector <Fileid>::iterator i = files.begin(); i != files.end(); i++) {
-		if (table_is_enabled(t_files)) {
-			cout << "INSERT INTO FILES VALUES("
-			    << i->get_id() << ",'"
-			    << i->get_path() << "',"
-			    << db->boolval(i->get_readonly());
-			cout << ");\n";
-			// Pre-cpp
-			cout << "INSERT INTO FILEMETRICS VALUES("
-			    << i->get_id() << ","
-			    << db->boolval(true);
-			for (int j = 0; j < FileMetrics::metric_max; j++) {
-				if (Metrics::is_internal<FileMetrics>(j))
-					continue;
-				if (Metrics::is_pre_cpp<FileMetrics>(j))
-					cout << ',' << Filedetails::get_pre_cpp_metrics(*i).get_metric(j);
-				else
-					cout << ",NULL";
-			}
-			cout << ");\n";
-			// Post-cpp
-			cout << "INSERT INTO FILEMETRICS VALUES("
-			    << i->get_id() << ","
-			    << db->boolval(false);
-			for (int j = 0; j < FileMetrics::metric_max; j++) {
-				if (Metrics::is_internal<FileMetrics>(j))
-					continue;
-				if (Metrics::is_post_cpp<FileMetrics>(j))
-					cout << ',' << Filedetails::get_post_cpp_metrics(*i).get_metric(j);
-				else
-					cout << ",NULL";
+	/*
+	 * Details and contents of each file.
+	 * The rows of a batch of files are produced concurrently,
+	 * and then output in file order.
+	 */
+	size_t batch = Parallel::get_jobs() * 16;
+	for (size_t b = 0; b < files.size(); b += batch) {
+		size_t n = min(batch, files.size() - b);
+		vector <FileDump> dumps(n);
+		Parallel::for_each_index(n, [&](size_t j) {
+			file_rows(db, dumps[j], files[b + j]);
+		});
+		for (size_t j = 0; j < n; j++) {
+			file_output(db, of, dumps[j]);
+			// Release the memory as soon as possible
+			dumps[j] = FileDump();
+
+			// Copies of the file
+			Fileid fid(files[b + j]);
+			const set <Fileid> &copies(Filedetails::get_identical_files(fid));
+			if (copies.size() > 1
+			    && table_is_enabled(t_filecopies)
+			    && copies.begin()->get_id() == fid.get_id()) {
+				for (set <Fileid>::const_iterator i = copies.begin(); i != copies.end(); i++)
+					SqlRow(db, of, "FILECOPIES") << groupnum << i->get_id();
+				groupnum++;
 			}
-			cout << ");\n";
-		}
-		// This invalidates the file's metrics
-		file_dump(db, cout, *i);
-		// The projects this file belongs to
-		for (unsigned j = attr_end; j < Attributes::get_num_attributes(); j++)
-			if (Filedetails::get_attribute(*i, j) && table_is_enabled(t_fileproj))
-				cout << "INSERT INTO FILEPROJ VALUES("
-				     << i->get_id() << ',' << j << ");\n";
-
-		// Copies of the file
-		const set <Fileid> &copies(Filedetails::get_identical_files(*i));
-		if (copies.size() > 1
-		    && table_is_enabled(t_filecopies)
-		    && copies.begin()->get_id() == i->get_id()) {
-			for (set <Fileid>::const_iterator j = copies.begin(); j != copies.end(); j++)
-				cout << "INSERT INTO FILECOPIES VALUES("
-				     << groupnum << ',' << j->get_id()
-				     << ");\n";
-			groupnum++;
 		}
 	}
 }
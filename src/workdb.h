@@ -65,6 +65,12 @@ bool table_is_enabled(enum e_table t);
 // Output the database schema
 void workdb_schema(Sql *db, ostream &of);
 
+/*
+ * Output commands that create indexes on the columns used for joining
+ * tables.  These are created after the data have been loaded.
+ */
+void workdb_indexes(ostream &of);
+
 // Output database data
 void workdb_rest(Sql *db, ostream &of);
 